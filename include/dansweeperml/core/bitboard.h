@@ -0,0 +1,100 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_BITBOARD_H
+#define DANSWEEPER_ML_BITBOARD_H
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Bitboard {
+
+    // one bit per cell, rows packed into 64 bit words
+    // every row is padded with a zero word on both sides and the plane with a zero row on top and bottom
+    // so shift kernels can read neighbours without bounds checks
+    class Bitplane {
+    public:
+
+        Bitplane() = default;
+        Bitplane(int width, int height);
+
+        void resize(int width, int height);
+        void clear();
+        void clearRows(int rowBegin, int rowEnd);
+
+        bool test(int x, int y) const { return row(y)[x >> 6] >> (x & 63) & 1; }
+        void set(int x, int y) { row(y)[x >> 6] |= std::uint64_t{1} << (x & 63); }
+        void reset(int x, int y) { row(y)[x >> 6] &= ~(std::uint64_t{1} << (x & 63)); }
+        void flip(int x, int y) { row(y)[x >> 6] ^= std::uint64_t{1} << (x & 63); }
+        void setRange(int y, int begin, int end);
+
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+        int getRowWords() const { return rowWords; }
+
+        // valid for y in [-1, height], padding rows are always zero
+        std::uint64_t* row(int y) { return words.data() + (y + 1) * stride + 1; }
+        const std::uint64_t* row(int y) const { return words.data() + (y + 1) * stride + 1; }
+
+        // bits past width in the last word of a row must stay zero
+        std::uint64_t getTailMask() const { return tailMask; }
+
+        std::uint64_t count() const;
+
+        // calls f(x, y) for every set bit in rows [rowBegin, rowEnd)
+        template<class F>
+        void forEachSet(int rowBegin, int rowEnd, F&& f) const {
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                const std::uint64_t* r = row(y);
+                for (int w = 0; w < rowWords; ++w) {
+                    for (std::uint64_t bits = r[w]; bits != 0; bits &= bits - 1) {
+                        f((w << 6) + std::countr_zero(bits), y);
+                    }
+                }
+            }
+        }
+
+        template<class F>
+        void forEachSet(F&& f) const { forEachSet(0, height, std::forward<F>(f)); }
+
+    private:
+
+        int width = 0;
+        int height = 0;
+        int rowWords = 0;
+        int stride = 0;
+        std::uint64_t tailMask = 0;
+        std::vector<std::uint64_t> words;
+    };
+
+    // horizontal run of cells [begin, end) in row y
+    struct Span {
+        int y;
+        int begin;
+        int end;
+    };
+
+    // reused across floodFill calls so a fill does not allocate once warmed up
+    struct FloodScratch {
+        std::vector<Span> spans;
+    };
+
+    // number of set 8-neighbours per cell, one byte per cell row major
+    // optionally marks cells that are clear and have no set neighbours
+    // rows are independent, threads > 1 splits them into that many bands
+    void countNeighbors(const Bitplane& plane, std::uint8_t* counts, Bitplane* isolatedOut = nullptr, unsigned threads = 1);
+
+    // scanline fill from every passable (x, y) seed at once, the 8-connected passable cells and their 8-neighbours join region
+    // cells in either blocked plane never join, every cell is marked once and never queued twice
+    // seeds that are not passable or already joined add nothing
+    // returns the row range [first, second) the new cells lie in, empty if no seed was passable
+    std::pair<int, int> floodFill(Bitplane& region, std::span<const std::pair<int, int>> seeds, const Bitplane& passable,
+                                  const Bitplane& blockedA, const Bitplane& blockedB, FloodScratch& scratch);
+
+} // Bitboard
+
+#endif //DANSWEEPER_ML_BITBOARD_H
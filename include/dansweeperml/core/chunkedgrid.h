@@ -0,0 +1,146 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_CHUNKEDGRID_H
+#define DANSWEEPER_ML_CHUNKEDGRID_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dansweeperml/core/grid.h>
+
+namespace Grid {
+
+    // one journal record per cell mutation on a chunked grid, cells have no flat index that fits 32 bits
+    struct PointDelta {
+        int x;
+        int y;
+        PackedCell before;
+        PackedCell after;
+    };
+
+    // effectively unbounded board made of fixed size chunks that only exist once something touches them
+    // mines of a chunk come from a hash of (seed, chunk coordinate) so any chunk can be built in any order
+    // a chunk's cells need the mines of its 8 neighbour chunks for border adjacency, those are kept as bare mine words
+    // memory grows with the explored area, there is no win, a board ends when a mine is hit
+    class ChunkedGrid {
+    public:
+
+        static constexpr int CHUNK_BITS = 6;
+        static constexpr int CHUNK_SIZE = 1 << CHUNK_BITS;
+        static constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE;
+
+        // cells per side, nobody walks off it and pixel coordinates still fit a float exactly
+        static constexpr int EXTENT = 1 << 20;
+        static constexpr int CHUNKS_PER_SIDE = EXTENT / CHUNK_SIZE;
+
+        // cells a single zero opening reveals at most, sparse boards would otherwise flood forever
+        // revealed zeros left on the edge of a capped opening still mark their neighbours safe
+        static constexpr size_t FLOOD_LIMIT = 1 << 20;
+
+        explicit ChunkedGrid(float mineDensity);
+
+        // width and height are EXTENT, mineNum is 0 since the board has no mine total
+        const GridMetadata& getMetadata() const { return metadata; }
+        int getWidth() const { return metadata.width; }
+        int getHeight() const { return metadata.height; }
+        GridState getGridState() const { return metadata.gridState; }
+        float getMineDensity() const { return mineDensity; }
+        void generateGrid(int safeX, int safeY);
+        void generateGrid(int safeX, int safeY, std::uint64_t seed);
+        bool getWinCondition();
+
+        // builds the cell's chunk if nobody touched it yet
+        Cell getCellProperties(int x, int y);
+
+        // packed accessors never build chunks, cells of untouched chunks read as hidden empty cells
+        PackedCell getPacked(int x, int y) const;
+        bool isMine(int x, int y) const { return getPacked(x, y) & CellBits::MINE; }
+        bool isRevealed(int x, int y) const { return getPacked(x, y) & CellBits::REVEALED; }
+        bool isFlagged(int x, int y) const { return getPacked(x, y) & CellBits::FLAGGED; }
+        int getAdjacentMines(int x, int y) const { return getPacked(x, y) & CellBits::ADJACENT_MASK; }
+        Tile::TileId getRenderTile(int x, int y) const { return renderTileOf(getPacked(x, y), metadata.gridState); }
+
+        // CHUNK_CELLS packed cells row major, nullptr for chunks that were never built
+        const PackedCell* findChunk(int chunkX, int chunkY) const;
+
+        // calls f(chunkX, chunkY, cells) for every built chunk, in no particular order
+        template<class F>
+        void forEachChunk(F&& f) const {
+            for (const auto& [key, chunk] : cellChunks) {
+                f(static_cast<int>(key & 0xFFFFFFFF), static_cast<int>(key >> 32), chunk->cells.data());
+            }
+        }
+
+        std::uint64_t getRevealedCount() const { return revealedCount; }
+        size_t getChunkCount() const { return cellChunks.size(); }
+        size_t getMemoryBytes() const;
+
+        // same contract as Grid::readJournal, a mismatch means rereading every built chunk
+        bool readJournal(JournalCursor& cursor, std::span<const PointDelta>& changes);
+        std::uint64_t getEpoch() const { return epoch; }
+        std::uint64_t getMutationCount() const { return mutationCount; }
+
+        void reveal(int x, int y);
+        void flag(int x, int y);
+        void chord(int x, int y);
+        void updateTimer();
+        void setClock(Clock clock);
+
+    private:
+
+        // one word per row, bit x is cell x
+        using MineChunk = std::array<std::uint64_t, CHUNK_SIZE>;
+
+        struct CellChunk {
+            std::array<PackedCell, CHUNK_CELLS> cells{};
+        };
+
+        GridMetadata metadata;
+        float mineDensity;
+        int minesPerChunk;
+
+        std::unordered_map<std::uint64_t, MineChunk> mineChunks;
+        std::unordered_map<std::uint64_t, std::unique_ptr<CellChunk>> cellChunks;
+
+        // last chunk cellAt resolved, floods and chords stay in one chunk most of the time
+        std::uint64_t lastKey = 0;
+        CellChunk* lastChunk = nullptr;
+
+        // chunk plus a one cell border of its neighbours, adjacency is counted on this
+        Bitboard::Bitplane halo;
+        std::vector<std::uint8_t> haloCounts;
+        std::vector<std::pair<int, int>> floodStack;
+
+        std::uint64_t revealedCount = 0;
+
+        // no board size to scale the journal limit by, restarts and pauses like Grid's
+        std::vector<PointDelta> journal;
+        std::uint64_t epoch = 0;
+        std::uint64_t mutationCount = 0;
+        bool journalPaused = false;
+
+        Clock clock;
+        double startTime = 0.0;
+        float timeElapsed = 0.0f;
+
+        static std::uint64_t chunkKey(int chunkX, int chunkY);
+        bool validateCoordinates(int x, int y) const;
+        const MineChunk& mineChunk(int chunkX, int chunkY);
+        CellChunk& cellChunk(int chunkX, int chunkY);
+        PackedCell& cellAt(int x, int y);
+        void endRevealAll(int x, int y);
+        void markRevealed(int x, int y, PackedCell& cell);
+        void writeCell(int x, int y, PackedCell& cell, PackedCell after);
+
+    };
+
+} // Grid
+
+#endif //DANSWEEPER_ML_CHUNKEDGRID_H
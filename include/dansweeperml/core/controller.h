@@ -7,10 +7,12 @@
 #include <raylib.h>
 
 #include "grid.h"
+#include "chunkedgrid.h"
 
 namespace Controller {
 
     void initializeController(Camera2D& cam, Grid::Grid* g);
+    void initializeController(Camera2D& cam, Grid::ChunkedGrid* g);
 
     void cameraZoom();
     void cameraPan();
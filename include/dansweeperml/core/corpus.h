@@ -0,0 +1,103 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_CORPUS_H
+#define DANSWEEPER_ML_CORPUS_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <dansweeperml/core/grid.h>
+
+// binary board corpus, little endian, every field 8 byte aligned
+//
+//   CorpusHeader
+//   per board: BoardRecord, then height * ((width + 63) / 64) mine words, row major
+//   std::uint64_t offset of every board record, starting at header.tableOffset
+//
+// boards are loaded straight from the mapped file, no rng or placement work
+namespace Corpus {
+
+    constexpr char MAGIC[4] = {'D', 'S', 'W', 'C'};
+    constexpr std::uint32_t VERSION = 1;
+
+    // records wider or taller than this are rejected as corrupt
+    constexpr std::uint32_t MAX_SIDE = 1 << 16;
+
+    struct CorpusHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t boardCount;
+        std::uint64_t tableOffset;
+    };
+
+    struct BoardRecord {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t mineNum;
+        std::uint32_t safeX;
+        std::uint32_t safeY;
+        std::uint32_t reserved;
+        std::uint64_t seed;
+    };
+
+    static_assert(sizeof(CorpusHeader) == 24);
+    static_assert(sizeof(BoardRecord) == 32);
+
+    class CorpusWriter {
+    public:
+
+        // false once a write failed, the corpus is then incomplete and close fails too
+        bool open(const std::string& path);
+        bool add(const Grid::Grid& grid);
+        bool close();
+
+    private:
+
+        std::ofstream file;
+        std::vector<std::uint64_t> offsets;
+        std::vector<std::uint64_t> mineWords;
+    };
+
+    // read only mapping of a corpus file
+    class CorpusReader {
+    public:
+
+        CorpusReader() = default;
+        ~CorpusReader();
+
+        CorpusReader(const CorpusReader&) = delete;
+        CorpusReader& operator=(const CorpusReader&) = delete;
+
+        // every record and its mine words are checked against the mapping, a bad one rejects the whole file
+        bool open(const std::string& path);
+        void close();
+
+        std::uint64_t size() const { return header ? header->boardCount : 0; }
+        const BoardRecord& getRecord(std::uint64_t board) const;
+        const std::uint64_t* getMineWords(std::uint64_t board) const;
+
+        // replaces grid's board, the grid takes the record's dimensions
+        void load(std::uint64_t board, Grid::Grid& grid) const;
+
+    private:
+
+        const unsigned char* data = nullptr;
+        std::uint64_t length = 0;
+        const CorpusHeader* header = nullptr;
+        const std::uint64_t* table = nullptr;
+
+        bool validRecord(std::uint64_t offset) const;
+
+#if defined(_WIN32)
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+
+} // Corpus
+
+#endif //DANSWEEPER_ML_CORPUS_H
@@ -7,9 +7,13 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <cstdint>
+#include <span>
 #include <mutex>
 #include <shared_mutex>
 #include <dansweeperml/core/tile.h>
+#include <dansweeperml/core/bitboard.h>
 
 inline std::shared_mutex gGridMtx;
 
@@ -32,7 +36,8 @@ namespace Grid {
         int height;
         int width;
         int mineNum;
-        int prng;
+        // seed the mines were placed from, seed64 is the same value as 16 hex digits
+        std::uint64_t prng;
         int safeX;
         int safeY;
         std::string seed64;
@@ -40,8 +45,55 @@ namespace Grid {
         GridState gridState = ONGOING;
     };
 
+    // packed cell storage, one byte per cell
+    // low nibble holds the adjacent mine count, high nibble holds state flags
+    using PackedCell = std::uint8_t;
+
+    namespace CellBits {
+        constexpr PackedCell ADJACENT_MASK = 0x0F;
+        constexpr PackedCell MINE = 1 << 4;
+        constexpr PackedCell REVEALED = 1 << 5;
+        constexpr PackedCell FLAGGED = 1 << 6;
+        constexpr PackedCell HIT = 1 << 7;
+    }
+
+    // render tile is derived from packed state instead of being stored
+    inline Tile::TileId renderTileOf(PackedCell cell, GridState state) {
+
+        if (cell & CellBits::REVEALED) {
+            if (cell & CellBits::MINE) {
+                return (cell & CellBits::HIT) ? Tile::TILE_MINE_HIT : Tile::TILE_MINE_REVEALED;
+            }
+
+            int adjacent = cell & CellBits::ADJACENT_MASK;
+            return adjacent == 0 ? Tile::TILE_REVEALED : static_cast<Tile::TileId>(Tile::TILE_1 + (adjacent - 1));
+        }
+
+        if (cell & CellBits::FLAGGED) {
+            return (state == FINISHED_LOSE && !(cell & CellBits::MINE)) ? Tile::TILE_MINE_WRONG : Tile::TILE_FLAG;
+        }
+
+        return Tile::TILE_BLANK;
+    }
+
+    // one journal record per cell mutation
+    struct CellDelta {
+        std::uint32_t index;
+        PackedCell before;
+        PackedCell after;
+    };
+
+    // read position into the grid journal
+    // an epoch mismatch means the journal restarted since the cursor was taken
+    // either the board was regenerated or the journal overflowed
+    struct JournalCursor {
+        std::uint64_t epoch = 0;
+        size_t position = 0;
+    };
+
     // cell interactable content
     // a way to link between renderable and literal grid content
+    // decoded value type, grid itself stores PackedCell
     struct Cell {
         CellContent content = CELL_EMPTY;
         Tile::TileId renderTile = Tile::TILE_BLANK;
@@ -52,6 +104,24 @@ namespace Grid {
         bool operator==(const Cell&) const = default;
     };
 
+    // moves of one solver step by flat index, applied together by Grid::apply
+    // flags set rather than toggle, chords only open when their flag count matches
+    struct ActionBatch {
+        std::vector<int> reveals;
+        std::vector<int> flags;
+        std::vector<int> chords;
+
+        bool empty() const { return reveals.empty() && flags.empty() && chords.empty(); }
+        void clear() {
+            reveals.clear();
+            flags.clear();
+            chords.clear();
+        }
+    };
+
+    // seconds from an arbitrary origin, injectable so grids run without a window
+    using Clock = std::function<double()>;
+
     class Grid {
     public:
 
@@ -59,31 +129,106 @@ namespace Grid {
         Grid(int height, int width, int mineNum);
         Grid(int height, int width, float mineDensity);
 
-        GridMetadata getMetadata();
-        std::vector<std::vector<Cell>>& getCells();
+        // metadata by reference, dimensions and state without touching seed64
+        const GridMetadata& getMetadata() const { return metadata; }
+        int getWidth() const { return metadata.width; }
+        int getHeight() const { return metadata.height; }
+        int getMineNum() const { return metadata.mineNum; }
+        GridState getGridState() const { return metadata.gridState; }
         void generateGrid(int safeX, int safeY);
+        void generateGrid(int safeX, int safeY, std::uint64_t seed);
+
+        // replaces the board with stored mines, words are row major with (width + 63) / 64 words per row
+        void loadBoard(int height, int width, int mineNum, int safeX, int safeY, std::uint64_t seed, const std::uint64_t* mineWords);
+        void saveMines(std::uint64_t* mineWords) const;
+
+        // exchanges boards with other in constant time, this grid's readers see a new epoch and its timer restarts
+        // the clock stays with each grid, other keeps this grid's old board
+        void swapBoard(Grid& other);
         bool getWinCondition();
         Cell getCellProperties(int x, int y);
 
+        // row major packed accessors, coordinates are not validated
+        int index(int x, int y) const { return y * metadata.width + x; }
+        PackedCell getPacked(int x, int y) const { return cells[index(x, y)]; }
+        bool isMine(int x, int y) const { return getPacked(x, y) & CellBits::MINE; }
+        bool isRevealed(int x, int y) const { return getPacked(x, y) & CellBits::REVEALED; }
+        bool isFlagged(int x, int y) const { return getPacked(x, y) & CellBits::FLAGGED; }
+        int getAdjacentMines(int x, int y) const { return getPacked(x, y) & CellBits::ADJACENT_MASK; }
+        Tile::TileId getRenderTile(int x, int y) const { return renderTileOf(getPacked(x, y), metadata.gridState); }
+        // row major read only view, valid until the next board swap or resize
+        std::span<const PackedCell> getCells() const { return cells; }
+        int getSafeCellsLeft() const { return safeCellsLeft; }
+
+        // changes since cursor, valid until the next mutation, cursor moves to the end
+        // returns false when the cursor predates the current board, the whole board must be reread
+        bool readJournal(JournalCursor& cursor, std::span<const CellDelta>& changes);
+        std::uint64_t getEpoch() const { return epoch; }
+
+        // cell writes since construction, never resets, cheap "did anything change" check
+        std::uint64_t getMutationCount() const { return mutationCount; }
+
+        // bitplane views, cheap whole board masks for solvers
+        const Bitboard::Bitplane& getRevealedPlane() const { return revealedPlane; }
+        const Bitboard::Bitplane& getFlaggedPlane() const { return flaggedPlane; }
+
         void reveal(int x, int y);
+
+        // opens every hidden unflagged flat index with one flood fill and one win check
+        // a mine among them ends the board there, the targets after it stay hidden
+        void revealMany(std::span<const int> targets);
         void flag(int x, int y);
         void chord(int x, int y);
+
+        // flags first, then chords and reveals share one flood fill and one win check
+        // a mine among the reveals ends the board there, later reveals are dropped
+        void apply(const ActionBatch& actions);
         void updateTimer();
+        void setClock(Clock clock);
 
 
 
     private:
 
         GridMetadata metadata;
-        std::vector<std::vector<Cell>> cells;
-
-        double startTime;
-        float timeElapsed;
+        std::vector<PackedCell> cells;
+
+        // safe cells still hidden, kept by markRevealed so the win check is O(1)
+        int safeCellsLeft = 0;
+
+        // every cell write after generation goes through writeCell and lands here
+        // generateGrid starts a new epoch instead of logging every cell
+        // past journalLimit entries the journal restarts too, rereading the board is cheaper by then
+        // recording then pauses until somebody reads, nobody could use those entries
+        std::vector<CellDelta> journal;
+        std::uint64_t epoch = 0;
+        std::uint64_t mutationCount = 0;
+        size_t journalLimit = 0;
+        bool journalPaused = false;
+
+        // bitplanes mirror the packed flags, openPlane marks safe cells with no adjacent mines
+        Bitboard::Bitplane minePlane;
+        Bitboard::Bitplane revealedPlane;
+        Bitboard::Bitplane flaggedPlane;
+        Bitboard::Bitplane openPlane;
+        Bitboard::Bitplane regionPlane;
+        Bitboard::FloodScratch floodScratch;
+        std::vector<std::pair<int, int>> floodSeeds;
+        std::vector<int> pendingReveals;
+
+        Clock clock;
+        double startTime = 0.0;
+        float timeElapsed = 0.0f;
 
         bool validateCoordinates(int x, int y);
         void initializeEmptyGrid(int height, int width, int mineNum);
-        void generatePrng();
+        std::uint64_t generatePrng();
+        void beginBoard(int safeX, int safeY, std::uint64_t seed);
+        void finishBoard();
         void endRevealAll(int x, int y);
+        void markRevealed(int x, int y);
+        void addChordTargets(int flat);
+        void writeCell(int flat, PackedCell after);
 
     };
 
@@ -0,0 +1,33 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_HIGHLIGHT_H
+#define DANSWEEPER_ML_HIGHLIGHT_H
+
+#include <chrono>
+#include <functional>
+
+// solver side of the highlight trail, kept free of raylib so solvers run headless
+// a fixed ring one solver thread writes without locking or waiting and the render thread reads in place
+namespace Highlight {
+
+    struct HighlightedTile {
+        int x;
+        int y;
+        std::chrono::steady_clock::time_point spawn;
+    };
+
+    // tiles outside bounds are dropped, nothing is queued until bounds are set
+    void setBounds(int width, int height);
+
+    // producer side, one thread at a time, a full ring overwrites its oldest tile
+    void queueHighlightTile(int x, int y);
+    void resetHighlightTiles();
+
+    // render thread only, oldest first, tiles older than lifetime are skipped and never visited again
+    void forEachHighlightTile(std::chrono::milliseconds lifetime, const std::function<void(const HighlightedTile&)>& f);
+
+} // Highlight
+
+#endif //DANSWEEPER_ML_HIGHLIGHT_H
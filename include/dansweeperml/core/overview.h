@@ -0,0 +1,90 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_OVERVIEW_H
+#define DANSWEEPER_ML_OVERVIEW_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <dansweeperml/core/grid.h>
+
+namespace Grid {
+
+    // revealed, flagged and mine counts per block of a board, at every power of two block size from BLOCK tiles up
+    // one writer keeps it current from cell deltas, readers see relaxed counts that may trail the writer by a delta
+    // enough to draw a board far too large to draw tile by tile
+    //
+    // readers cache pictures of REGION x REGION texels, a texel is 1 << scale tiles a side
+    // every change stamps the region it falls in at every scale, a picture built before its region's stamp is stale
+    class BoardOverview {
+    public:
+
+        static constexpr int BLOCK = 4;
+        static constexpr int BLOCK_SCALE = 2;
+        static constexpr int REGION = 64;
+
+        static_assert(1 << BLOCK_SCALE == BLOCK);
+
+        struct Level {
+            int blockTiles = 0;
+            int blocksX = 0;
+            int blocksY = 0;
+            std::unique_ptr<std::atomic<std::uint32_t>[]> revealed;
+            std::unique_ptr<std::atomic<std::uint32_t>[]> flagged;
+            std::unique_ptr<std::atomic<std::uint32_t>[]> mines;
+        };
+
+        // allocates every level, before any reader looks
+        void resize(int width, int height);
+
+        // recounts from a whole board of the resized size
+        void rebuild(std::span<const PackedCell> cells);
+        void apply(const CellDelta& delta);
+
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+
+        // level 0 has BLOCK tiles a side, the last level is a single block
+        int getLevelCount() const { return static_cast<int>(levels.size()); }
+        const Level& getLevel(int level) const { return levels[level]; }
+
+        // scales 0 up to the last level's, scales from BLOCK_SCALE read level scale - BLOCK_SCALE
+        int getScaleCount() const { return static_cast<int>(stamps.size()); }
+        int getRegionsX(int scale) const { return stamps[scale].regionsX; }
+        int getRegionsY(int scale) const { return stamps[scale].regionsY; }
+
+        // counts every change, a reader that read it first sees the counts of every change up to it
+        std::uint64_t getChangeCount() const { return changes.load(std::memory_order_acquire); }
+
+        // change count of the last change in the region, or of the last resize or rebuild when that came later
+        std::uint64_t getChangedAt(int scale, int regionX, int regionY) const {
+            const Stamps& s = stamps[scale];
+            return std::max(s.changed[static_cast<size_t>(regionY) * s.regionsX + regionX].load(std::memory_order_relaxed),
+                            rebuiltAt.load(std::memory_order_relaxed));
+        }
+
+    private:
+
+        struct Stamps {
+            int regionsX = 0;
+            int regionsY = 0;
+            std::unique_ptr<std::atomic<std::uint64_t>[]> changed;
+        };
+
+        int width = 0;
+        int height = 0;
+        std::vector<Level> levels;
+        std::vector<Stamps> stamps;
+        std::atomic<std::uint64_t> changes{0};
+        std::atomic<std::uint64_t> rebuiltAt{0};
+    };
+
+} // Grid
+
+#endif //DANSWEEPER_ML_OVERVIEW_H
@@ -7,22 +7,18 @@
 
 #include <raylib.h>
 #include <dansweeperml/core/grid.h>
-#include <chrono>
+#include <dansweeperml/core/chunkedgrid.h>
+#include <dansweeperml/core/snapshot.h>
 
 namespace Render {
 
-    struct HighlightedTile {
-        int x;
-        int y;
-        std::chrono::steady_clock::time_point spawn;
-    };
-
     void loadTexture();
     void unloadTexture();
-    void initializeRender(Camera2D& cam, Grid::Grid* grid);
+    // flat boards are drawn from the latest published snapshot, the renderer never touches the live grid
+    void initializeRender(Camera2D& cam, Grid::SnapshotPublisher* snapshots);
+    // chunks that were never built draw as hidden cells
+    void initializeRender(Camera2D& cam, Grid::ChunkedGrid* grid);
     void renderThread(bool drawHighlight);
-    void queueHighlightTile(int x, int y);
-    void resetHighlightTiles();
 
 } // Render
 
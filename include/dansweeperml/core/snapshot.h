@@ -0,0 +1,121 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_SNAPSHOT_H
+#define DANSWEEPER_ML_SNAPSHOT_H
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <dansweeperml/core/grid.h>
+#include <dansweeperml/core/overview.h>
+
+namespace Grid {
+
+    // a board as it was after one step, never written once published
+    struct BoardSnapshot {
+        GridMetadata metadata;
+        std::vector<PackedCell> cells;
+
+        // grid mutation count the snapshot was taken at
+        std::uint64_t version = 0;
+
+        PackedCell getPacked(int x, int y) const { return cells[static_cast<size_t>(y) * metadata.width + x]; }
+    };
+
+    // tiles changed since a reader last took them, one bit per tile and a summary flag per CHUNK x CHUNK square
+    // the publisher marks a change only after the snapshot holding it is out,
+    // so a reader that takes its dirty tiles before acquiring a snapshot always draws them current
+    class DirtyTiles {
+    public:
+
+        static constexpr int CHUNK = 32;
+
+        // sizes and clears, before any reader looks
+        void resize(int width, int height);
+
+        void mark(int x, int y);
+        void markAll();
+
+        // true once after markAll, every tile should be redrawn
+        bool takeAll() { return all.exchange(false, std::memory_order_acquire); }
+
+        // clears the chunk and calls f(x, y) for each of its dirty tiles, false when it was clean
+        template<class F>
+        bool takeChunk(int chunkX, int chunkY, F&& f) {
+            if (chunkX < 0 || chunkX >= chunksX || chunkY < 0 || chunkY >= chunksY ||
+                !chunks[static_cast<size_t>(chunkY) * chunksX + chunkX].exchange(0, std::memory_order_acquire)) {
+                return false;
+            }
+
+            // a chunk is half a word, CHUNK divides 64
+            const int word = chunkX * CHUNK / 64;
+            const int shift = chunkX * CHUNK % 64;
+            const std::uint64_t mask = ((std::uint64_t{1} << CHUNK) - 1) << shift;
+            for (int y = chunkY * CHUNK; y < std::min((chunkY + 1) * CHUNK, height); y++) {
+                std::uint64_t bits = tiles[static_cast<size_t>(y) * rowWords + word].fetch_and(~mask, std::memory_order_acquire) & mask;
+                for (; bits != 0; bits &= bits - 1) {
+                    f(word * 64 + std::countr_zero(bits), y);
+                }
+            }
+            return true;
+        }
+
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+
+    private:
+        int width = 0;
+        int height = 0;
+        int rowWords = 0;
+        int chunksX = 0;
+        int chunksY = 0;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> tiles;
+        std::unique_ptr<std::atomic<std::uint8_t>[]> chunks;
+        std::atomic<bool> all{false};
+    };
+
+    // the thread that owns a grid publishes snapshots of it, any other thread reads the latest without locking
+    // buffers are recycled once no reader holds them and caught up from the grid journal instead of copied whole
+    class SnapshotPublisher {
+    public:
+
+        // writer only, skipped when nothing changed or every buffer is still being read
+        void publish(Grid& grid);
+
+        // null before the first publish, stays valid for as long as the caller holds it
+        std::shared_ptr<const BoardSnapshot> acquire() const { return latest.load(std::memory_order_acquire); }
+
+        // sized by the first publish, boards of another size later only ever mark everything
+        DirtyTiles& getDirtyTiles() { return dirty; }
+        const BoardOverview& getOverview() const { return overview; }
+
+    private:
+
+        struct Buffer {
+            std::shared_ptr<BoardSnapshot> snapshot;
+            JournalCursor cursor;
+        };
+
+        // one published, one a reader may still hold, one to write
+        std::array<Buffer, 3> buffers;
+        std::atomic<std::shared_ptr<const BoardSnapshot>> latest;
+        DirtyTiles dirty;
+        BoardOverview overview;
+        JournalCursor dirtyCursor;
+        GridState publishedState = ONGOING;
+        std::uint64_t publishedVersion = 0;
+        std::uint64_t publishedEpoch = 0;
+        float publishedTime = 0.0f;
+        bool published = false;
+    };
+
+} // Grid
+
+#endif //DANSWEEPER_ML_SNAPSHOT_H
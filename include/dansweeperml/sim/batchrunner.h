@@ -0,0 +1,62 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_BATCHRUNNER_H
+#define DANSWEEPER_ML_BATCHRUNNER_H
+
+#include <cstdint>
+#include <string>
+
+#include <dansweeperml/core/chunkedgrid.h>
+#include <dansweeperml/core/corpus.h>
+#include <dansweeperml/core/grid.h>
+#include <dansweeperml/solver/isolver.h>
+#include <dansweeperml/solver/solverstats.h>
+
+// runs solvers over many boards without a window, no pacing and no render handshake
+namespace Sim {
+
+    struct BatchConfig {
+        int height = 9;
+        int width = 9;
+        int mineNum = 10;
+        int boards = 1000;
+
+        // board i is generated from firstSeed + i, so runs are reproducible
+        std::uint64_t firstSeed = 0;
+
+        // guards against solvers that never finish a board
+        int maxStepsPerBoard = 1000000;
+
+        // empty keeps the grid's steady clock
+        Grid::Clock clock;
+    };
+
+    // steps the solver on an already generated grid until the board ends or the solver gives up
+    // returns the final state, ONGOING when the solver got stuck
+    Grid::GridState runBoard(ISolver& solver, Grid::Grid& grid, int maxSteps, int& steps);
+    Grid::GridState runBoard(ISolver& solver, Grid::ChunkedGrid& grid, int maxSteps, int& steps);
+
+    SolverStats runBatch(ISolver& solver, const BatchConfig& config);
+
+    // plays every board of a corpus, boards come from the mapping instead of being generated
+    SolverStats runCorpus(ISolver& solver, const Corpus::CorpusReader& corpus, int maxStepsPerBoard);
+
+    // unbounded boards cannot be won, progress is how far a solver gets before a mine or the step cap
+    struct UnboundedStats {
+        std::string name;
+        int boardsRun = 0;
+        int lose = 0;
+        double averageSteps = 0.0;
+        double averageRevealed = 0.0;
+        double averageChunks = 0.0;
+        size_t peakBytes = 0;
+    };
+
+    // plays config.boards unbounded boards, config's dimensions and mine count are unused
+    UnboundedStats runUnbounded(ISolver& solver, float mineDensity, const BatchConfig& config);
+
+} // Sim
+
+#endif //DANSWEEPER_ML_BATCHRUNNER_H
@@ -0,0 +1,51 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_PREGENERATOR_H
+#define DANSWEEPER_ML_PREGENERATOR_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <dansweeperml/core/grid.h>
+
+namespace Sim {
+
+    // boards generated ahead on a background thread while the current one is played
+    // taking one swaps its buffers into the live grid, the old buffers come back and are regenerated in place
+    class BoardPregenerator {
+    public:
+
+        // depth boards of the given size are kept ready, all generated safe at (safeX, safeY)
+        BoardPregenerator(int height, int width, int mineNum, int safeX, int safeY, int depth = 2);
+        ~BoardPregenerator();
+
+        BoardPregenerator(const BoardPregenerator&) = delete;
+        BoardPregenerator& operator=(const BoardPregenerator&) = delete;
+
+        // swaps the next ready board into grid, false when the worker has not caught up yet
+        bool swapNext(Grid::Grid& grid);
+
+    private:
+
+        int safeX;
+        int safeY;
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<std::unique_ptr<Grid::Grid>> ready;
+        std::vector<std::unique_ptr<Grid::Grid>> spare;
+        bool stopping = false;
+
+        std::thread worker;
+
+        void run();
+    };
+
+} // Sim
+
+#endif //DANSWEEPER_ML_PREGENERATOR_H
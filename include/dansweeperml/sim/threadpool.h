@@ -0,0 +1,83 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_THREADPOOL_H
+#define DANSWEEPER_ML_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Sim {
+
+    // work stealing pool, every worker owns a deque and takes its newest task first
+    // idle workers steal the oldest task of another worker, queues are locked one at a time
+    class ThreadPool {
+    public:
+
+        explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // tasks submitted from a worker go to that worker's own deque
+        void submit(std::function<void()> task);
+
+        // runs one queued task on the calling thread, false if none was found
+        bool runPendingTask();
+
+        unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+        // index of the calling worker in its pool, -1 outside any pool
+        static int getWorkerIndex();
+
+    private:
+
+        struct Queue {
+            std::mutex mtx;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        bool tryPop(int self, std::function<void()>& task);
+        void workerLoop(int self);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::jthread> workers;
+        std::atomic<long long> pending{0};
+        std::atomic<size_t> nextQueue{0};
+
+        // only used to park idle workers
+        std::mutex sleepMtx;
+        std::condition_variable sleepCv;
+        bool stopping = false;
+    };
+
+    // tracks a batch of tasks, wait() runs queued tasks while the batch is unfinished
+    // so a worker may wait on tasks it spawned without starving the pool
+    class TaskGroup {
+    public:
+
+        explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+        ~TaskGroup() { wait(); }
+
+        void run(std::function<void()> task);
+        void wait();
+
+    private:
+
+        ThreadPool& pool;
+        std::atomic<size_t> remaining{0};
+        std::mutex doneMtx;
+        std::condition_variable doneCv;
+    };
+
+} // Sim
+
+#endif //DANSWEEPER_ML_THREADPOOL_H
@@ -0,0 +1,56 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_TOURNAMENT_H
+#define DANSWEEPER_ML_TOURNAMENT_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <dansweeperml/solver/solverstats.h>
+
+namespace Sim {
+
+    struct BoardConfig {
+        int height = 9;
+        int width = 9;
+        int mineNum = 10;
+    };
+
+    // every solver plays boardsPerConfig boards of every board config
+    struct TournamentConfig {
+        std::vector<std::string> solverKeys;
+        std::vector<BoardConfig> boardConfigs;
+        int boardsPerConfig = 1000;
+
+        // board i of every config comes from firstSeed + i, every solver plays the same boards
+        std::uint64_t firstSeed = 0;
+
+        // boards per pool task, small enough to balance and large enough to amortise the queue
+        int boardsPerTask = 64;
+        int maxStepsPerBoard = 1000000;
+        unsigned threads = 0;
+
+        // pool size of every parallel solver, 0 splits the cores between the tournament's threads
+        // so board level and component level parallelism never ask for more threads than there are cores
+        unsigned solverThreads = 0;
+
+        // handed to every solver, zero leaves steps unbounded
+        std::chrono::microseconds stepBudget{0};
+    };
+
+    struct TournamentResult {
+        std::string solverKey;
+        BoardConfig boardConfig;
+        SolverStats stats;
+    };
+
+    // one result per (solver, board config), solver then config order, unknown keys are skipped
+    std::vector<TournamentResult> runTournament(const TournamentConfig& config);
+
+} // Sim
+
+#endif //DANSWEEPER_ML_TOURNAMENT_H
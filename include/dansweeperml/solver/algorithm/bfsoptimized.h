@@ -6,6 +6,7 @@
 #define DANSWEEPER_ML_BFSUNOPTIMIZED_H
 #include <dansweeperml/solver/isolver.h>
 #include <set>
+#include <random>
 
 namespace algorithmbfsoptimized {
 
@@ -14,6 +15,8 @@ namespace algorithmbfsoptimized {
     public:
 
         bool step(Grid::Grid& grid) override;
+        bool step(Grid::ChunkedGrid& grid) override;
+        bool stepActions(Grid::Grid& grid, Grid::ActionBatch& actions) override;
         int getSteps() override;
         void reset() override;
         std::string getName() override;
@@ -24,8 +27,19 @@ namespace algorithmbfsoptimized {
     private:
         std::set<std::pair<int, int>> visited;
         std::set<std::pair<int, int>> revealedNumberTiles;
+        Grid::JournalCursor journalCursor;
+        Grid::ActionBatch batch;
         bool started = false;
+        // per instance so solvers can run on several threads at once
+        std::mt19937 rng{std::random_device{}()};
         std::vector<std::pair<int, int>> getNeighbors(int x, int y, int width, int height);
+
+        // same walk on either board, reads come from the board and moves go to moves,
+        // which is the board itself or a batch the caller applies after the step
+        template<class Board, class Moves>
+        bool stepOn(Board& grid, Moves& moves);
+        void collectNumberTiles(Grid::Grid& grid);
+        void collectNumberTiles(Grid::ChunkedGrid& grid);
     };
 
 } // algorithmbfsunoptimized
@@ -0,0 +1,91 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_FRONTIER_H
+#define DANSWEEPER_ML_FRONTIER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <dansweeperml/solver/isolver.h>
+
+namespace algorithmfrontier {
+
+    // constraint propagation over the frontier, revealed numbers that still have unknown neighbours
+    // the frontier is kept up to date from journal deltas, only numbers near a change are re-examined
+    // a worklist runs the single cell and pairwise subset rules to a fixpoint, every forced move is played in one step
+    class FrontierSolver : public ISolver {
+
+    public:
+
+        // a batch built by stepActions and applied in one pass
+        bool step(Grid::Grid& grid) override;
+        bool stepActions(Grid::Grid& grid, Grid::ActionBatch& actions) override;
+        int getSteps() override;
+        void reset() override;
+        std::string getName() override;
+
+    protected:
+        std::string name = "frontier";
+
+        // unknown neighbours of a revealed number and how many of them are mines
+        // unknown means hidden, unflagged and not deduced this step
+        struct Constraint {
+            int cells[8];
+            int count = 0;
+            int mines = 0;
+        };
+
+        // nothing was forced, play one move anyway, false when there is nothing left to try
+        // the default takes the lowest local mine ratio on the frontier
+        virtual bool guess(const Grid::Grid& grid, Grid::ActionBatch& actions);
+
+        Constraint getConstraint(const Grid::Grid& grid, int cell) const;
+
+        // a hidden unflagged cell that touches no frontier number, -1 if there is none
+        // corners first since they open most often
+        int findInteriorCell(const Grid::Grid& grid) const;
+
+        int width = 0;
+        int height = 0;
+
+        // flat indices of frontier numbers, unordered
+        std::vector<int> frontier;
+
+        // restarted from the step budget at the top of every step, guesses that search watch it
+        StepDeadline deadline;
+
+    private:
+
+        enum Deduction : std::uint8_t {
+            UNKNOWN,
+            DEDUCED_SAFE,
+            DEDUCED_MINE
+        };
+
+        std::vector<int> frontierPos;
+        std::vector<int> worklist;
+        std::vector<char> queued;
+        std::vector<std::uint8_t> deduced;
+        std::vector<int> safeMoves;
+        std::vector<int> mineMoves;
+        Grid::ActionBatch batch;
+
+        Grid::JournalCursor journalCursor;
+        bool started = false;
+
+        void resize(const Grid::Grid& grid);
+        void collectChanges(Grid::Grid& grid);
+        void enqueue(const Grid::Grid& grid, int cell);
+        void enqueueNumberNeighbors(const Grid::Grid& grid, int cell);
+        void propagate(const Grid::Grid& grid);
+        bool applyPair(const Grid::Grid& grid, const Constraint& a, const Constraint& b);
+        void markSafe(const Grid::Grid& grid, int cell);
+        void markMine(const Grid::Grid& grid, int cell);
+        void setFrontier(int cell, bool member);
+    };
+
+} // algorithmfrontier
+
+#endif //DANSWEEPER_ML_FRONTIER_H
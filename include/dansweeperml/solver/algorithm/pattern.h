@@ -0,0 +1,53 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_PATTERN_H
+#define DANSWEEPER_ML_PATTERN_H
+
+#include <cstdint>
+#include <vector>
+
+#include <dansweeperml/solver/algorithm/bfsoptimized.h>
+
+namespace algorithmpattern {
+
+    // table lookups in front of the bfs walk
+    // a number's 3x3 neighbourhood, each neighbour clear, unknown or flagged, indexes a compile time table of forced moves
+    // numbers up to two apart share part of their 5x5 window, their overlap and counts index a second table
+    // only when neither table forces anything does the step fall through to bfs
+    class PatternSolver : public algorithmbfsoptimized::BFSUnoptimized {
+
+    public:
+
+        using BFSUnoptimized::step;
+        bool step(Grid::Grid& grid) override;
+        // table moves and bfs fallback moves both go in the batch
+        bool stepActions(Grid::Grid& grid, Grid::ActionBatch& actions) override;
+        void reset() override;
+        std::string getName() override;
+
+    protected:
+        std::string name = "pattern";
+
+    private:
+
+        Grid::JournalCursor patternCursor;
+
+        // numbers whose neighbourhood changed since they were last looked up
+        std::vector<int> queue;
+        std::vector<char> queued;
+        std::vector<char> marked;
+        std::vector<int> safeMoves;
+        std::vector<int> mineMoves;
+        Grid::ActionBatch batch;
+
+        void collectChanges(Grid::Grid& grid);
+        void enqueueAround(const Grid::Grid& grid, int cell);
+        void lookup(const Grid::Grid& grid, int cell);
+        void mark(int cell, bool mine);
+    };
+
+} // algorithmpattern
+
+#endif //DANSWEEPER_ML_PATTERN_H
@@ -0,0 +1,128 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_PROBABILITY_H
+#define DANSWEEPER_ML_PROBABILITY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <dansweeperml/sim/threadpool.h>
+#include <dansweeperml/solver/algorithm/frontier.h>
+
+namespace algorithmprobability {
+
+    // frontier cells linked through shared constraints, enumerated independently of every other component
+    // variables are in enumeration order, neighbours in the constraint graph sit close together
+    struct Component {
+        std::vector<int> cells;
+        std::vector<int> targets;
+        std::vector<std::vector<int>> constraintVars;
+        std::vector<std::vector<int>> varConstraints;
+
+        bool operator==(const Component&) const = default;
+    };
+
+    // configuration counts by number of mines m in the component
+    // cellWays[v * (cells + 1) + m] counts the configurations with variable v a mine
+    struct ComponentResult {
+        std::vector<double> ways;
+        std::vector<double> cellWays;
+    };
+
+    // nodes and time shared by every enumeration of one guess
+    struct SearchBudget {
+        std::atomic<std::int64_t> nodes;
+        StepDeadline deadline;
+    };
+
+    // pruned backtracking over every configuration of the component, adds into result
+    // fixed pins the first fixed.size() variables, so one component can be split into independent pieces
+    // false once the budget runs out, result is then partial
+    bool enumerateComponent(const Component& component, ComponentResult& result,
+                            SearchBudget& budget, std::span<const std::uint8_t> fixed = {});
+
+    // frontier propagation first, when nothing is forced every frontier cell gets its exact mine probability
+    // components are enumerated on their own so the cost is a sum over components, not a product
+    // the global mine count weighs component mine totals by the ways to place the rest in the unconstrained interior
+    // with threads > 1 components fan out over a pool and large components split on their first variables
+    // counts survive between steps, a component no move touched is not enumerated again
+    // and one cut off by the step budget carries on from its last finished piece
+    class ProbabilitySolver : public algorithmfrontier::FrontierSolver {
+
+    public:
+
+        explicit ProbabilitySolver(unsigned threads = 1);
+
+        std::string getName() override;
+
+    protected:
+        std::string name = "probability";
+
+        bool guess(const Grid::Grid& grid, Grid::ActionBatch& actions) override;
+
+        // fills probabilities per component variable and the probability of an interior cell
+        // false when nothing usable came out, the guess then falls back to the local ratio
+        // the default counts exactly and sets exact, only exact probabilities may play cells as certain
+        virtual bool estimate(const Grid::Grid& grid, double& interiorProbability);
+
+        // mines not yet flagged and hidden cells outside every component
+        void countUnknowns(const Grid::Grid& grid, std::int64_t& minesLeft, std::int64_t& interior) const;
+
+        std::unique_ptr<Sim::ThreadPool> pool;
+
+        std::vector<Component> components;
+        std::vector<double> probabilities;
+        bool exact = true;
+
+        bool solveComponents();
+
+    private:
+
+        // search nodes one guess may spend before falling back to the local ratio guess
+        static constexpr std::int64_t NODE_BUDGET = 1ll << 24;
+
+        // smaller components are cheaper to enumerate whole than to split
+        static constexpr size_t SPLIT_VARIABLES = 24;
+
+        // pieces per large component on one thread under a step budget, so a cut off enumeration can resume
+        static constexpr int RESUME_SPLIT_DEPTH = 6;
+
+        // counts of one component so far, piece i pins the first depth variables to the bits of i
+        struct Progress {
+            Component component;
+            ComponentResult result;
+            int depth = 0;
+            std::vector<std::uint8_t> finished;
+            bool complete = false;
+        };
+
+        int splitDepth = 0;
+
+        std::vector<Progress> progress;
+        std::vector<ComponentResult> results;
+        std::vector<int> varOf;
+
+        void buildComponents(const Grid::Grid& grid);
+
+        // progress of every current component, carried over when an identical component was counted before
+        void matchProgress();
+
+        // cells every configuration of a finished component agrees on, safe whatever the global weighting
+        // the best a guess cut off by the step budget can do before the local ratio
+        bool playCertainCells(Grid::ActionBatch& actions);
+
+        void playAll(Grid::ActionBatch& actions, const std::vector<int>& safe, const std::vector<int>& mines);
+
+        // fills probabilities per component variable, returns the probability of an interior cell
+        // negative when the counts admit no board at all
+        double combine(const Grid::Grid& grid);
+    };
+
+} // algorithmprobability
+
+#endif //DANSWEEPER_ML_PROBABILITY_H
@@ -0,0 +1,75 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_SAMPLING_H
+#define DANSWEEPER_ML_SAMPLING_H
+
+#include <cstdint>
+
+#include <dansweeperml/solver/algorithm/probability.h>
+
+namespace algorithmsampling {
+
+    struct SamplingConfig {
+
+        // a frontier with a component larger than this is sampled instead of counted
+        size_t enumerationVariables = 40;
+
+        // independent chains, two at least so they can be compared
+        unsigned chains = 4;
+
+        // one sweep resamples about every variable once
+        int burnInSweeps = 8;
+        int roundSweeps = 32;
+
+        // rounds stop once every variable's R-hat is under targetRhat, or after maxRounds
+        int maxRounds = 4;
+        double targetRhat = 1.05;
+
+        // most variables one move resamples together, at most 64
+        int blockVariables = 48;
+
+        std::uint64_t seed = 0;
+    };
+
+    // exact probabilities while every component is small enough to count
+    // past that, markov chains over consistent mine placements estimate them
+    // a move resamples a ball of linked variables given the rest, weighted by the ways to fill the interior,
+    // so every state satisfies every number and the global mine count
+    // cost per guess is bounded by the config and the step budget, chains run on the pool when there are threads
+    // chains start from where the last guess left them, so later guesses need less burn in to settle
+    class SamplingSolver : public algorithmprobability::ProbabilitySolver {
+
+    public:
+
+        explicit SamplingSolver(unsigned threads = 1, SamplingConfig config = {});
+
+        // chains start cold and reseed from config.seed, a board plays the same whatever ran before it
+        void reset() override;
+        std::string getName() override;
+
+        // largest Gelman-Rubin R-hat over frontier variables of the last sampled guess, 0 before any
+        double getLastRhat() const;
+
+    protected:
+        std::string name = "sampling";
+
+        bool estimate(const Grid::Grid& grid, double& interiorProbability) override;
+
+    private:
+
+        SamplingConfig config;
+        std::uint64_t draws = 0;
+        double lastRhat = 0.0;
+
+        // last placement of every chain by cell, 2 where a cell was not a variable
+        std::vector<std::vector<std::uint8_t>> warm;
+
+        // false when no chain found a consistent start
+        bool sample(const Grid::Grid& grid, double& interiorProbability);
+    };
+
+} // algorithmsampling
+
+#endif //DANSWEEPER_ML_SAMPLING_H
@@ -5,7 +5,25 @@
 #ifndef DANSWEEPER_ML_ISOLVER_H
 #define DANSWEEPER_ML_ISOLVER_H
 
+#include <chrono>
+
 #include <dansweeperml/core/grid.h>
+#include <dansweeperml/core/chunkedgrid.h>
+
+// a point on the steady clock a step should return by, never expires when the budget is zero
+class StepDeadline {
+public:
+
+    StepDeadline() = default;
+    explicit StepDeadline(std::chrono::microseconds budget)
+        : bounded(budget.count() > 0), end(std::chrono::steady_clock::now() + budget) {}
+
+    bool expired() const { return bounded && std::chrono::steady_clock::now() >= end; }
+
+private:
+    bool bounded = false;
+    std::chrono::steady_clock::time_point end;
+};
 
 // every solver will take a step, private x y, amount of steps taken, and reset
 class ISolver {
@@ -13,12 +31,24 @@ public:
 
     virtual ~ISolver() = 0;
     virtual bool step(Grid::Grid& grid) = 0;
+    // unbounded boards, solvers that cannot play them give up straight away
+    virtual bool step(Grid::ChunkedGrid&) { return false; }
+
+    // the moves of one step without playing them, the caller plays the batch with Grid::apply
+    // solvers that play as they go keep the default, which steps the grid itself and leaves the batch empty
+    virtual bool stepActions(Grid::Grid& grid, Grid::ActionBatch&) { return step(grid); }
     virtual std::string getName() = 0;
     virtual int getSteps() = 0;
     virtual void reset() = 0;
 
+    // time one step may take, zero is unbounded and the default
+    // solvers that search return the best move they have when it runs out and keep what they finished for the next step
+    void setStepBudget(std::chrono::microseconds budget) { stepBudget = budget; }
+    std::chrono::microseconds getStepBudget() const { return stepBudget; }
+
 protected:
     std::string name = "";
+    std::chrono::microseconds stepBudget{0};
     int x = 0;
     int y = 0;
     int steps = 0;
@@ -32,10 +32,8 @@ namespace features {
     // featurize in 3x3 patch
     inline void featurize(Grid::Grid& grid, int cx, int cy, std::vector<double>& outputFeature) {
 
-        const auto& cells = grid.getCells();
-        const auto meta = grid.getMetadata();
-        const int width = meta.width;
-        const int height = meta.height;
+        const int width = grid.getWidth();
+        const int height = grid.getHeight();
 
         int unrevealed = 0;
         int flagged = 0;
@@ -51,18 +49,18 @@ namespace features {
                 // search in bounds of grid
                 if (x >= 0 && y >= 0 && x < width && y < height) {
 
-                    const auto& checkCell = cells[y][x];
+                    const Grid::PackedCell checkCell = grid.getPacked(x, y);
 
-                    if (checkCell.revealed) {
+                    if (checkCell & Grid::CellBits::REVEALED) {
                         adjacentRevealed++;
-                        adjacentMineSum += checkCell.adjacentMines;
+                        adjacentMineSum += checkCell & Grid::CellBits::ADJACENT_MASK;
                     }
 
-                    if (checkCell.flagged) {
+                    if (checkCell & Grid::CellBits::FLAGGED) {
                         flagged++;
                     }
 
-                    if (!checkCell.revealed) {
+                    if (!(checkCell & Grid::CellBits::REVEALED)) {
                         unrevealed++;
                     }
 
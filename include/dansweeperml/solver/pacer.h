@@ -0,0 +1,80 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_PACER_H
+#define DANSWEEPER_ML_PACER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+
+// how fast the window's solver thread steps while it is not paused
+enum PacingMode {
+    PACE_UNTHROTTLED,
+    PACE_RATE,
+    PACE_FRAME_LOCKED,
+};
+
+// gates the solver thread's steps, the render thread drives it with frames, key presses and wakes
+// a paused or waiting solver thread blocks on a condition variable instead of polling
+// unthrottled and unpaused never touches the lock, manual steps only matter while paused or paced
+class SolverPacer {
+public:
+
+    // about a frame at 60 fps
+    static constexpr std::chrono::microseconds FRAME_BUDGET{16000};
+
+    void setMode(PacingMode mode);
+    PacingMode getMode() const { return mode.load(std::memory_order_relaxed); }
+
+    void setStepsPerSecond(double rate);
+    double getStepsPerSecond() const { return stepsPerSecond.load(std::memory_order_relaxed); }
+
+    // frame locked steps granted per rendered frame, credits beyond one frame's worth are dropped
+    void setStepsPerFrame(int steps);
+    int getStepsPerFrame() const { return stepsPerFrame.load(std::memory_order_relaxed); }
+
+    void setPaused(bool paused);
+    bool isPaused() const { return paused.load(std::memory_order_relaxed); }
+
+    // time a searching solver's step may take, only solvers that search consult it
+    // a frame locked step gets its share of a frame, a paced step its interval up to a frame, an unthrottled step a frame
+    // zero, unbounded, while budgets are off
+    std::chrono::microseconds getStepBudget() const;
+    void setBudgeted(bool budgeted) { this->budgeted.store(budgeted, std::memory_order_relaxed); }
+    bool isBudgeted() const { return budgeted.load(std::memory_order_relaxed); }
+
+    // one step regardless of mode or pause
+    void requestStep();
+
+    // render thread, once per frame
+    void frameRendered();
+
+    // lets a blocked waitForStep return so the solver thread can look at selection changes or stop
+    void wake();
+
+    // blocks until the next step is due, false when woken, stopped or paused without a step
+    bool waitForStep(std::stop_token st);
+
+private:
+
+    std::atomic<PacingMode> mode{PACE_RATE};
+    std::atomic<double> stepsPerSecond{10.0};
+    std::atomic<int> stepsPerFrame{1};
+    std::atomic<bool> paused{false};
+    std::atomic<bool> budgeted{true};
+
+    std::mutex mtx;
+    std::condition_variable_any cv;
+    int frameCredits = 0;
+    bool stepRequested = false;
+    bool woken = false;
+    std::uint64_t version = 0;
+    std::chrono::steady_clock::time_point nextStep{};
+};
+
+#endif //DANSWEEPER_ML_PACER_H
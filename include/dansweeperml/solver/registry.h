@@ -0,0 +1,24 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_REGISTRY_H
+#define DANSWEEPER_ML_REGISTRY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dansweeperml/solver/isolver.h>
+
+// solvers that build without the gui or ml dependencies, looked up by key
+namespace SolverRegistry {
+
+    std::vector<std::string> getSolverKeys();
+
+    // nullptr for an unknown key
+    // threads sizes the pool of the parallel solvers, 0 gives them every core, the rest ignore it
+    std::unique_ptr<ISolver> makeSolver(const std::string& key, unsigned threads = 0);
+
+} // SolverRegistry
+
+#endif //DANSWEEPER_ML_REGISTRY_H
@@ -0,0 +1,59 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#ifndef DANSWEEPER_ML_SOLVERSTATS_H
+#define DANSWEEPER_ML_SOLVERSTATS_H
+
+#include <string>
+#include <dansweeperml/core/grid.h>
+
+struct SolverStats {
+    std::string name;
+    int steps = 0;
+    int totalSteps = 0;
+    float time = 0.0f;
+    float totalTime = 0.0f;
+    int boardsRun = 1;
+    int win = 0;
+    int lose = 0;
+    float winrate = 0.0f;
+    float averageSteps = 0.0f;
+    float averageTime = 0.0f;
+};
+
+// folds one finished board into running totals, boards stuck without a result count as neither win nor lose
+inline void recordBoard(SolverStats& stats, int steps, float time, Grid::GridState result) {
+    stats.steps = steps;
+    stats.time = time;
+    stats.totalSteps += steps;
+    stats.totalTime += time;
+    stats.boardsRun++;
+
+    if (result == Grid::FINISHED_WIN) {
+        stats.win++;
+    } else if (result == Grid::FINISHED_LOSE) {
+        stats.lose++;
+    }
+
+    stats.winrate = static_cast<float>(stats.win) / stats.boardsRun;
+    stats.averageSteps = static_cast<float>(stats.totalSteps) / stats.boardsRun;
+    stats.averageTime = stats.totalTime / stats.boardsRun;
+}
+
+// adds the totals of from into into, per board fields keep into's values
+inline void mergeStats(SolverStats& into, const SolverStats& from) {
+    into.totalSteps += from.totalSteps;
+    into.totalTime += from.totalTime;
+    into.boardsRun += from.boardsRun;
+    into.win += from.win;
+    into.lose += from.lose;
+
+    if (into.boardsRun > 0) {
+        into.winrate = static_cast<float>(into.win) / into.boardsRun;
+        into.averageSteps = static_cast<float>(into.totalSteps) / into.boardsRun;
+        into.averageTime = into.totalTime / into.boardsRun;
+    }
+}
+
+#endif //DANSWEEPER_ML_SOLVERSTATS_H
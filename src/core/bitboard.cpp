@@ -0,0 +1,367 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/core/bitboard.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Bitboard {
+
+    namespace {
+
+        // bits [begin, end) of word w, begin < end and the range overlaps the word
+        inline std::uint64_t rangeMask(int w, int begin, int end) {
+            const int lo = std::max(begin - (w << 6), 0);
+            const int hi = std::min(end - (w << 6), 64);
+            const std::uint64_t upper = (hi == 64) ? ~std::uint64_t{0} : (std::uint64_t{1} << hi) - 1;
+            return upper & (~std::uint64_t{0} << lo);
+        }
+
+    }
+
+    Bitplane::Bitplane(int width, int height) {
+        resize(width, height);
+    }
+
+    void Bitplane::resize(int width, int height) {
+        this->width = width;
+        this->height = height;
+        this->rowWords = (width + 63) / 64;
+        this->stride = rowWords + 2;
+        this->tailMask = (width % 64 == 0) ? ~std::uint64_t{0} : (std::uint64_t{1} << (width % 64)) - 1;
+        this->words.assign(static_cast<size_t>(height + 2) * stride, 0);
+    }
+
+    void Bitplane::clear() {
+        std::fill(words.begin(), words.end(), 0);
+    }
+
+    void Bitplane::clearRows(int rowBegin, int rowEnd) {
+        if (rowBegin < rowEnd) {
+            std::fill(row(rowBegin) - 1, row(rowEnd) - 1, 0);
+        }
+    }
+
+    void Bitplane::setRange(int y, int begin, int end) {
+        std::uint64_t* r = row(y);
+        for (int w = begin >> 6; begin < end && w <= (end - 1) >> 6; ++w) {
+            r[w] |= rangeMask(w, begin, end);
+        }
+    }
+
+    std::uint64_t Bitplane::count() const {
+        std::uint64_t total = 0;
+        for (const std::uint64_t word : words) {
+            total += std::popcount(word);
+        }
+        return total;
+    }
+
+    namespace {
+
+        // spreads the 8 bits of a byte into 8 bytes holding 0 or 1, little endian
+        constexpr std::array<std::uint64_t, 256> makeSpreadTable() {
+            std::array<std::uint64_t, 256> table{};
+            for (int b = 0; b < 256; ++b) {
+                for (int j = 0; j < 8; ++j) {
+                    if (b >> j & 1) {
+                        table[b] |= std::uint64_t{1} << (8 * j);
+                    }
+                }
+            }
+            return table;
+        }
+
+        constexpr std::array<std::uint64_t, 256> spreadTable = makeSpreadTable();
+
+        // a lane processes WIDTH consecutive words of a row at once
+        // west(p) moves every cell's left neighbour onto it, east(p) the right neighbour
+        struct ScalarLane {
+            using Word = std::uint64_t;
+            static constexpr int WIDTH = 1;
+
+            static Word load(const std::uint64_t* p) { return *p; }
+            static void store(std::uint64_t* p, Word w) { *p = w; }
+            static Word west(const std::uint64_t* p) { return (p[0] << 1) | (p[-1] >> 63); }
+            static Word east(const std::uint64_t* p) { return (p[0] >> 1) | (p[1] << 63); }
+        };
+
+#if defined(__AVX2__)
+        struct Avx2Word {
+            __m256i v;
+        };
+
+        inline Avx2Word operator&(Avx2Word a, Avx2Word b) { return {_mm256_and_si256(a.v, b.v)}; }
+        inline Avx2Word operator|(Avx2Word a, Avx2Word b) { return {_mm256_or_si256(a.v, b.v)}; }
+        inline Avx2Word operator^(Avx2Word a, Avx2Word b) { return {_mm256_xor_si256(a.v, b.v)}; }
+
+        struct Avx2Lane {
+            using Word = Avx2Word;
+            static constexpr int WIDTH = 4;
+
+            static Word load(const std::uint64_t* p) {
+                return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+            }
+            static void store(std::uint64_t* p, Word w) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), w.v);
+            }
+            static Word west(const std::uint64_t* p) {
+                return {_mm256_or_si256(_mm256_slli_epi64(load(p).v, 1), _mm256_srli_epi64(load(p - 1).v, 63))};
+            }
+            static Word east(const std::uint64_t* p) {
+                return {_mm256_or_si256(_mm256_srli_epi64(load(p).v, 1), _mm256_slli_epi64(load(p + 1).v, 63))};
+            }
+        };
+
+        using WideLane = Avx2Lane;
+#else
+        using WideLane = ScalarLane;
+#endif
+
+        template<class W>
+        struct Sum {
+            W bit0, bit1, bit2, bit3;
+        };
+
+        template<class W>
+        inline W majority(W a, W b, W c) {
+            return (a & b) | (c & (a ^ b));
+        }
+
+        // bit sliced adder, each output word holds one bit of the per cell sum of eight inputs
+        template<class W>
+        inline Sum<W> sum8(W a, W b, W c, W d, W e, W f, W g, W h) {
+            const W s0 = a ^ b ^ c, c0 = majority(a, b, c);
+            const W s1 = d ^ e ^ f, c1 = majority(d, e, f);
+            const W s2 = g ^ h, c2 = g & h;
+
+            const W carry = majority(s0, s1, s2);
+            const W t0 = c0 ^ c1 ^ c2, t1 = majority(c0, c1, c2);
+            const W u = t0 & carry;
+
+            return {s0 ^ s1 ^ s2, t0 ^ carry, t1 ^ u, t1 & u};
+        }
+
+        // counts 8-neighbours for the words [w, rowWords) of row y in steps of Lane::WIDTH, returns the first word left over
+        template<class Lane>
+        int countRow(const Bitplane& plane, int y, int w, std::uint8_t* counts, Bitplane* isolatedOut) {
+
+            const std::uint64_t* up = plane.row(y - 1);
+            const std::uint64_t* mid = plane.row(y);
+            const std::uint64_t* down = plane.row(y + 1);
+            const int width = plane.getWidth();
+
+            for (; w + Lane::WIDTH <= plane.getRowWords(); w += Lane::WIDTH) {
+
+                const Sum<typename Lane::Word> sum = sum8(
+                    Lane::load(up + w), Lane::west(up + w), Lane::east(up + w),
+                    Lane::west(mid + w), Lane::east(mid + w),
+                    Lane::load(down + w), Lane::west(down + w), Lane::east(down + w));
+
+                std::uint64_t bits[4][Lane::WIDTH];
+                Lane::store(bits[0], sum.bit0);
+                Lane::store(bits[1], sum.bit1);
+                Lane::store(bits[2], sum.bit2);
+                Lane::store(bits[3], sum.bit3);
+
+                for (int k = 0; k < Lane::WIDTH; ++k) {
+
+                    const int word = w + k;
+
+                    if (isolatedOut) {
+                        std::uint64_t isolated = ~(bits[0][k] | bits[1][k] | bits[2][k] | bits[3][k] | mid[word]);
+                        if (word == plane.getRowWords() - 1) {
+                            isolated &= plane.getTailMask();
+                        }
+                        isolatedOut->row(y)[word] = isolated;
+                    }
+
+                    // eight cells per table lookup
+                    for (int j = 0; j < 8; ++j) {
+                        const int x0 = word * 64 + j * 8;
+                        if (x0 >= width) {
+                            break;
+                        }
+
+                        const int shift = j * 8;
+                        const std::uint64_t spread = spreadTable[bits[0][k] >> shift & 0xFF]
+                                                   | spreadTable[bits[1][k] >> shift & 0xFF] << 1
+                                                   | spreadTable[bits[2][k] >> shift & 0xFF] << 2
+                                                   | spreadTable[bits[3][k] >> shift & 0xFF] << 3;
+
+                        std::memcpy(counts + static_cast<size_t>(y) * width + x0, &spread, std::min(8, width - x0));
+                    }
+                }
+            }
+
+            return w;
+        }
+
+    }
+
+    void countNeighbors(const Bitplane& plane, std::uint8_t* counts, Bitplane* isolatedOut, unsigned threads) {
+
+        auto countBand = [&](int rowBegin, int rowEnd) {
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                int w = countRow<WideLane>(plane, y, 0, counts, isolatedOut);
+                countRow<ScalarLane>(plane, y, w, counts, isolatedOut);
+            }
+        };
+
+        const int height = plane.getHeight();
+        const int bands = static_cast<int>(std::clamp<unsigned>(threads, 1u, static_cast<unsigned>(std::max(height, 1))));
+        if (bands == 1) {
+            countBand(0, height);
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        for (int band = 1; band < bands; ++band) {
+            workers.emplace_back(countBand, height * band / bands, height * (band + 1) / bands);
+        }
+        countBand(0, height / bands);
+    }
+
+    namespace {
+
+        class SpanFiller {
+        public:
+
+            SpanFiller(Bitplane& region, const Bitplane& passable, const Bitplane& blockedA, const Bitplane& blockedB)
+                : region(region), passable(passable), blockedA(blockedA), blockedB(blockedB) {}
+
+            // passable cells that have not joined yet
+            std::uint64_t freeBits(int y, int w) const {
+                return passable.row(y)[w] & ~blockedA.row(y)[w] & ~blockedB.row(y)[w] & ~region.row(y)[w];
+            }
+
+            // first cell at or after free cell x that is not free
+            int extendRight(int y, int x) const {
+                int w = x >> 6;
+                const int run = std::countr_one(freeBits(y, w) >> (x & 63));
+                if (run < 64 - (x & 63)) {
+                    return x + run;
+                }
+
+                for (++w; w < region.getRowWords(); ++w) {
+                    const std::uint64_t bits = freeBits(y, w);
+                    if (bits != ~std::uint64_t{0}) {
+                        return (w << 6) + std::countr_one(bits);
+                    }
+                }
+                return region.getRowWords() << 6;
+            }
+
+            // first cell of the free run ending at free cell x
+            int extendLeft(int y, int x) const {
+                int w = x >> 6;
+                const int run = std::countl_one(freeBits(y, w) << (63 - (x & 63)));
+                if (run <= (x & 63)) {
+                    return x - run + 1;
+                }
+
+                for (--w; w >= 0; --w) {
+                    const std::uint64_t bits = freeBits(y, w);
+                    if (bits != ~std::uint64_t{0}) {
+                        return ((w + 1) << 6) - std::countl_one(bits);
+                    }
+                }
+                return 0;
+            }
+
+            // marks the free run through x and queues it
+            void claim(int y, int x, std::vector<Span>& spans) {
+                const int begin = extendLeft(y, x);
+                const int end = extendRight(y, x);
+                region.setRange(y, begin, end);
+                spans.push_back({y, begin, end});
+            }
+
+            // claims every free run touching cells [begin, end) of row y
+            void scanRow(int y, int begin, int end, std::vector<Span>& spans) {
+                for (int w = begin >> 6; w <= (end - 1) >> 6; ++w) {
+                    const std::uint64_t mask = rangeMask(w, begin, end);
+                    for (std::uint64_t bits = freeBits(y, w) & mask; bits != 0; bits = freeBits(y, w) & mask) {
+                        claim(y, (w << 6) + std::countr_zero(bits), spans);
+                    }
+                }
+            }
+
+            // unblocked cells of [begin, end) in row y join region
+            void addBorder(int y, int begin, int end) {
+                for (int w = begin >> 6; w <= (end - 1) >> 6; ++w) {
+                    region.row(y)[w] |= rangeMask(w, begin, end) & ~blockedA.row(y)[w] & ~blockedB.row(y)[w];
+                }
+            }
+
+        private:
+
+            Bitplane& region;
+            const Bitplane& passable;
+            const Bitplane& blockedA;
+            const Bitplane& blockedB;
+        };
+
+    }
+
+    std::pair<int, int> floodFill(Bitplane& region, std::span<const std::pair<int, int>> seeds, const Bitplane& passable,
+                                  const Bitplane& blockedA, const Bitplane& blockedB, FloodScratch& scratch) {
+
+        SpanFiller filler(region, passable, blockedA, blockedB);
+        const int width = region.getWidth();
+        const int height = region.getHeight();
+
+        // spans doubles as the work queue and the record of every claimed run
+        std::vector<Span>& spans = scratch.spans;
+        spans.clear();
+        for (const auto& [seedX, seedY] : seeds) {
+            if (filler.freeBits(seedY, seedX >> 6) >> (seedX & 63) & 1) {
+                filler.claim(seedY, seedX, spans);
+            }
+        }
+        if (spans.empty()) {
+            return {0, 0};
+        }
+
+        for (size_t next = 0; next < spans.size(); ++next) {
+            const Span span = spans[next];
+            const int begin = std::max(span.begin - 1, 0);
+            const int end = std::min(span.end + 1, width);
+
+            if (span.y > 0) {
+                filler.scanRow(span.y - 1, begin, end, spans);
+            }
+            if (span.y + 1 < height) {
+                filler.scanRow(span.y + 1, begin, end, spans);
+            }
+        }
+
+        // neighbours of passable cells join once the passable part is complete
+        // doing it earlier would mark unvisited passable cells as done
+        int rowBegin = height;
+        int rowEnd = 0;
+        for (const Span& span : spans) {
+            const int begin = std::max(span.begin - 1, 0);
+            const int end = std::min(span.end + 1, width);
+            const int yBegin = std::max(span.y - 1, 0);
+            const int yEnd = std::min(span.y + 2, height);
+
+            for (int y = yBegin; y < yEnd; ++y) {
+                filler.addBorder(y, begin, end);
+            }
+            rowBegin = std::min(rowBegin, yBegin);
+            rowEnd = std::max(rowEnd, yEnd);
+        }
+
+        return {rowBegin, rowEnd};
+    }
+
+} // Bitboard
@@ -0,0 +1,369 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/core/chunkedgrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace Grid {
+
+    // journal restarts past this many entries, the board has no size to scale it by
+    static constexpr size_t JOURNAL_LIMIT = 1 << 16;
+
+    static constexpr int CHUNK_MASK = ChunkedGrid::CHUNK_SIZE - 1;
+    static constexpr int HALO_SIZE = ChunkedGrid::CHUNK_SIZE + 2;
+
+    // splitmix64 finaliser, neighbouring chunk coordinates give unrelated seeds
+    static std::uint64_t mix64(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    static double steadySeconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ChunkedGrid::ChunkedGrid(float mineDensity)
+        : mineDensity(mineDensity), halo(HALO_SIZE, HALO_SIZE),
+          haloCounts(static_cast<size_t>(HALO_SIZE) * HALO_SIZE), clock(steadySeconds) {
+
+        // every chunk holds the same number of mines so density is exact at any scale
+        // one cell per chunk is left free for the safe cell
+        this->minesPerChunk = std::clamp(static_cast<int>(std::lround(mineDensity * CHUNK_CELLS)), 0, CHUNK_CELLS - 1);
+
+        this->metadata.height = EXTENT;
+        this->metadata.width = EXTENT;
+        this->metadata.mineNum = 0;
+        this->metadata.prng = 0;
+        this->metadata.safeX = EXTENT / 2;
+        this->metadata.safeY = EXTENT / 2;
+        this->metadata.time = 0.0f;
+    }
+
+    void ChunkedGrid::generateGrid(int safeX, int safeY) {
+        const std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        generateGrid(safeX, safeY, mix64(ns));
+    }
+
+    // nothing is placed here, chunks are built from the seed when first touched
+    void ChunkedGrid::generateGrid(int safeX, int safeY, std::uint64_t seed) {
+
+        this->mineChunks.clear();
+        this->cellChunks.clear();
+        this->lastChunk = nullptr;
+        this->revealedCount = 0;
+
+        this->timeElapsed = 0.0f;
+        this->startTime = this->clock();
+        this->metadata.time = 0.0f;
+        this->metadata.safeX = safeX;
+        this->metadata.safeY = safeY;
+        this->metadata.gridState = ONGOING;
+        this->metadata.prng = seed;
+
+        std::ostringstream seedStream;
+        seedStream << std::hex << std::setw(16) << std::setfill('0') << seed;
+        this->metadata.seed64 = seedStream.str();
+
+        this->journal.clear();
+        this->journalPaused = false;
+        this->epoch++;
+
+    }
+
+    std::uint64_t ChunkedGrid::chunkKey(int chunkX, int chunkY) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkY)) << 32 | static_cast<std::uint32_t>(chunkX);
+    }
+
+    bool ChunkedGrid::validateCoordinates(int x, int y) const {
+        return (x >= 0 && x < EXTENT) && (y >= 0 && y < EXTENT);
+    }
+
+    const ChunkedGrid::MineChunk& ChunkedGrid::mineChunk(int chunkX, int chunkY) {
+
+        // chunks past the edge have no mines and are never stored
+        static const MineChunk emptyChunk{};
+        if (chunkX < 0 || chunkX >= CHUNKS_PER_SIDE || chunkY < 0 || chunkY >= CHUNKS_PER_SIDE) {
+            return emptyChunk;
+        }
+
+        auto [it, inserted] = this->mineChunks.try_emplace(chunkKey(chunkX, chunkY));
+        MineChunk& mines = it->second;
+        if (!inserted) {
+            return mines;
+        }
+
+        // the safe cell is pre-set so sampling skips it, then cleared again
+        const bool holdsSafe = (this->metadata.safeX >> CHUNK_BITS) == chunkX && (this->metadata.safeY >> CHUNK_BITS) == chunkY;
+        if (holdsSafe) {
+            mines[this->metadata.safeY & CHUNK_MASK] |= std::uint64_t{1} << (this->metadata.safeX & CHUNK_MASK);
+        }
+
+        // rejection sampling with the words as the chosen set
+        // CHUNK_CELLS is a power of two so the top bits of a draw are an unbiased cell
+        std::mt19937_64 gen(mix64(this->metadata.prng ^ mix64(chunkKey(chunkX, chunkY))));
+        for (int placed = 0; placed < this->minesPerChunk;) {
+            const int cell = static_cast<int>(gen() >> (64 - 2 * CHUNK_BITS));
+            std::uint64_t& word = mines[cell >> CHUNK_BITS];
+            const std::uint64_t bit = std::uint64_t{1} << (cell & CHUNK_MASK);
+            if (!(word & bit)) {
+                word |= bit;
+                placed++;
+            }
+        }
+
+        if (holdsSafe) {
+            mines[this->metadata.safeY & CHUNK_MASK] &= ~(std::uint64_t{1} << (this->metadata.safeX & CHUNK_MASK));
+        }
+
+        return mines;
+    }
+
+    ChunkedGrid::CellChunk& ChunkedGrid::cellChunk(int chunkX, int chunkY) {
+
+        auto [it, inserted] = this->cellChunks.try_emplace(chunkKey(chunkX, chunkY));
+        if (!inserted) {
+            return *it->second;
+        }
+        it->second = std::make_unique<CellChunk>();
+        CellChunk& chunk = *it->second;
+
+        // copy the chunk's mines and the touching column or row of each neighbour into the halo
+        // halo cell (x + 1, y + 1) is chunk cell (x, y)
+        for (int haloY = 0; haloY < HALO_SIZE; ++haloY) {
+            const int localY = haloY - 1;
+            const int sourceY = chunkY + (localY < 0 ? -1 : localY >= CHUNK_SIZE ? 1 : 0);
+            const int sourceRow = localY & CHUNK_MASK;
+
+            const std::uint64_t left = mineChunk(chunkX - 1, sourceY)[sourceRow] >> CHUNK_MASK;
+            const std::uint64_t centre = mineChunk(chunkX, sourceY)[sourceRow];
+            const std::uint64_t right = mineChunk(chunkX + 1, sourceY)[sourceRow] & 1;
+
+            std::uint64_t* row = this->halo.row(haloY);
+            row[0] = centre << 1 | left;
+            row[1] = centre >> CHUNK_MASK | right << 1;
+        }
+
+        Bitboard::countNeighbors(this->halo, this->haloCounts.data());
+
+        // mine cells keep only their flag, same as Grid
+        const MineChunk& mines = mineChunk(chunkX, chunkY);
+        for (int y = 0; y < CHUNK_SIZE; ++y) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                chunk.cells[y * CHUNK_SIZE + x] = (mines[y] >> x & 1)
+                    ? CellBits::MINE
+                    : this->haloCounts[(y + 1) * HALO_SIZE + x + 1];
+            }
+        }
+
+        return chunk;
+    }
+
+    PackedCell& ChunkedGrid::cellAt(int x, int y) {
+        const std::uint64_t key = chunkKey(x >> CHUNK_BITS, y >> CHUNK_BITS);
+        if (!this->lastChunk || key != this->lastKey) {
+            this->lastChunk = &cellChunk(x >> CHUNK_BITS, y >> CHUNK_BITS);
+            this->lastKey = key;
+        }
+        return this->lastChunk->cells[(y & CHUNK_MASK) * CHUNK_SIZE + (x & CHUNK_MASK)];
+    }
+
+    const PackedCell* ChunkedGrid::findChunk(int chunkX, int chunkY) const {
+        auto it = this->cellChunks.find(chunkKey(chunkX, chunkY));
+        return it == this->cellChunks.end() ? nullptr : it->second->cells.data();
+    }
+
+    PackedCell ChunkedGrid::getPacked(int x, int y) const {
+        const PackedCell* chunk = findChunk(x >> CHUNK_BITS, y >> CHUNK_BITS);
+        return chunk ? chunk[(y & CHUNK_MASK) * CHUNK_SIZE + (x & CHUNK_MASK)] : 0;
+    }
+
+    Cell ChunkedGrid::getCellProperties(int x, int y) {
+        const PackedCell packed = cellAt(x, y);
+
+        Cell cell;
+        cell.content = (packed & CellBits::MINE) ? CELL_MINE : CELL_EMPTY;
+        cell.renderTile = renderTileOf(packed, metadata.gridState);
+        cell.revealed = packed & CellBits::REVEALED;
+        cell.flagged = packed & CellBits::FLAGGED;
+        cell.adjacentMines = packed & CellBits::ADJACENT_MASK;
+        return cell;
+    }
+
+    // dfs fill reveal, chunks are built as the opening reaches them
+    void ChunkedGrid::reveal(int x, int y) {
+
+        if (!validateCoordinates(x, y)) {
+            return;
+        }
+
+        PackedCell& first = cellAt(x, y);
+
+        // ignore
+        if (first & (CellBits::REVEALED | CellBits::FLAGGED)) {
+            return;
+        }
+
+        if (first & CellBits::MINE) {
+            endRevealAll(x, y);
+            return;
+        }
+
+        markRevealed(x, y, first);
+        if ((first & CellBits::ADJACENT_MASK) != 0) {
+            return;
+        }
+
+        // cells are marked when pushed so nothing is queued twice, only zeros are pushed
+        size_t opened = 1;
+        this->floodStack.clear();
+        this->floodStack.emplace_back(x, y);
+
+        while (!this->floodStack.empty() && opened < FLOOD_LIMIT) {
+            auto [cx, cy] = this->floodStack.back();
+            this->floodStack.pop_back();
+
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int nx = cx + dx;
+                    const int ny = cy + dy;
+                    if ((dx == 0 && dy == 0) || !validateCoordinates(nx, ny)) continue;
+
+                    PackedCell& cell = cellAt(nx, ny);
+                    if (cell & (CellBits::REVEALED | CellBits::FLAGGED)) continue;
+
+                    markRevealed(nx, ny, cell);
+                    opened++;
+                    if ((cell & CellBits::ADJACENT_MASK) == 0) {
+                        this->floodStack.emplace_back(nx, ny);
+                    }
+                }
+            }
+        }
+
+    }
+
+    void ChunkedGrid::flag(int x, int y) {
+        if (validateCoordinates(x, y)) {
+            PackedCell& cell = cellAt(x, y);
+            if (!(cell & CellBits::REVEALED)) {
+                writeCell(x, y, cell, cell ^ CellBits::FLAGGED);
+            }
+        }
+    }
+
+    void ChunkedGrid::chord(int x, int y) {
+        if (validateCoordinates(x, y)) {
+            int flagCount = 0;
+
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int nx = x + dx;
+                    const int ny = y + dy;
+                    if (dx == 0 && dy == 0) continue;
+                    if (validateCoordinates(nx, ny) && (cellAt(nx, ny) & CellBits::FLAGGED)) {
+                        flagCount++;
+                    }
+                }
+            }
+
+            if (flagCount == (cellAt(x, y) & CellBits::ADJACENT_MASK)) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const int nx = x + dx;
+                        const int ny = y + dy;
+                        if (dx == 0 && dy == 0) continue;
+                        if (validateCoordinates(nx, ny) && !(cellAt(nx, ny) & (CellBits::FLAGGED | CellBits::REVEALED))) {
+                            reveal(nx, ny);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // no finite safe cell count to reach
+    bool ChunkedGrid::getWinCondition() {
+        return false;
+    }
+
+    // only mines of built chunks exist to be shown
+    void ChunkedGrid::endRevealAll(int hitX, int hitY) {
+        for (auto& [key, chunk] : this->cellChunks) {
+            const int originX = static_cast<int>(key & 0xFFFFFFFF) << CHUNK_BITS;
+            const int originY = static_cast<int>(key >> 32) << CHUNK_BITS;
+            for (int i = 0; i < CHUNK_CELLS; ++i) {
+                PackedCell& cell = chunk->cells[i];
+                if ((cell & CellBits::MINE) && !(cell & (CellBits::FLAGGED | CellBits::REVEALED))) {
+                    markRevealed(originX + (i & CHUNK_MASK), originY + (i >> CHUNK_BITS), cell);
+                }
+            }
+        }
+
+        PackedCell& hit = cellAt(hitX, hitY);
+        writeCell(hitX, hitY, hit, hit | CellBits::HIT);
+        this->metadata.gridState = FINISHED_LOSE;
+    }
+
+    // callers only pass hidden cells
+    void ChunkedGrid::markRevealed(int x, int y, PackedCell& cell) {
+        if (!(cell & CellBits::MINE)) {
+            this->revealedCount++;
+        }
+        writeCell(x, y, cell, cell | CellBits::REVEALED);
+    }
+
+    void ChunkedGrid::writeCell(int x, int y, PackedCell& cell, PackedCell after) {
+        if (!this->journalPaused && this->journal.size() >= JOURNAL_LIMIT) {
+            this->journal.clear();
+            this->journalPaused = true;
+            this->epoch++;
+        }
+
+        if (!this->journalPaused) {
+            this->journal.push_back({x, y, cell, after});
+        }
+        cell = after;
+        this->mutationCount++;
+    }
+
+    bool ChunkedGrid::readJournal(JournalCursor& cursor, std::span<const PointDelta>& changes) {
+        this->journalPaused = false;
+
+        if (cursor.epoch != this->epoch) {
+            cursor = {this->epoch, this->journal.size()};
+            changes = {};
+            return false;
+        }
+
+        changes = std::span<const PointDelta>(this->journal).subspan(cursor.position);
+        cursor.position = this->journal.size();
+        return true;
+    }
+
+    size_t ChunkedGrid::getMemoryBytes() const {
+        return this->mineChunks.size() * (sizeof(std::uint64_t) + sizeof(MineChunk))
+               + this->cellChunks.size() * (sizeof(std::uint64_t) + sizeof(CellChunk))
+               + this->journal.capacity() * sizeof(PointDelta);
+    }
+
+    void ChunkedGrid::updateTimer() {
+        const double now = this->clock();
+        this->timeElapsed = static_cast<float>(now - this->startTime);
+        this->metadata.time = this->timeElapsed;
+    }
+
+    void ChunkedGrid::setClock(Clock clock) {
+        this->clock = std::move(clock);
+    }
+
+} // Grid
@@ -28,6 +28,13 @@ namespace Controller {
         gridMetadata = grid->getMetadata();
     }
 
+    // camera only needs the board extent, clamping works the same
+    void Controller::initializeController(Camera2D& cam, Grid::ChunkedGrid* g) {
+        camera = &cam;
+        grid = nullptr;
+        gridMetadata = g->getMetadata();
+    }
+
     void Controller::cameraZoom() {
 
         float wheel = GetMouseWheelMove();
@@ -36,9 +43,15 @@ namespace Controller {
             Vector2 mousePos = GetMousePosition();
             Vector2 worldBefore = GetWorldToScreen2D(mousePos, *camera);
 
-            // clamp zoom
+            // clamp zoom, flat boards may zoom out until the whole board fits, the renderer switches to its overview
+            float minZoom = 1.0f;
+            if (grid) {
+                const float fit = std::min(GetScreenWidth() / static_cast<float>(gridMetadata.width * Tile::TILE_SIZE),
+                                           GetScreenHeight() / static_cast<float>(gridMetadata.height * Tile::TILE_SIZE));
+                minZoom = std::min(minZoom, fit);
+            }
             targetZoom *= (1.0f + zoomIncrement * wheel);
-            targetZoom = std::clamp(targetZoom, 1.0f, 10.0f);
+            targetZoom = std::clamp(targetZoom, minZoom, 10.0f);
 
             Vector2 worldAfter = GetWorldToScreen2D(mousePos, *camera);
             Vector2 diff = {
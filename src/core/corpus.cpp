@@ -0,0 +1,228 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/core/corpus.h>
+
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Corpus {
+
+    static std::uint64_t mineWordCount(std::uint64_t width, std::uint64_t height) {
+        return height * ((width + 63) / 64);
+    }
+
+    bool CorpusWriter::open(const std::string& path) {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "cannot write corpus " << path << std::endl;
+            return false;
+        }
+
+        // placeholder, rewritten by close once the table position is known
+        CorpusHeader header{};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        offsets.clear();
+        return true;
+    }
+
+    bool CorpusWriter::add(const Grid::Grid& grid) {
+        if (!file) {
+            return false;
+        }
+
+        const Grid::GridMetadata& meta = grid.getMetadata();
+
+        offsets.push_back(static_cast<std::uint64_t>(file.tellp()));
+
+        BoardRecord record{};
+        record.width = meta.width;
+        record.height = meta.height;
+        record.mineNum = meta.mineNum;
+        record.safeX = meta.safeX;
+        record.safeY = meta.safeY;
+        record.seed = meta.prng;
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+        mineWords.resize(mineWordCount(meta.width, meta.height));
+        grid.saveMines(mineWords.data());
+        file.write(reinterpret_cast<const char*>(mineWords.data()), mineWords.size() * sizeof(std::uint64_t));
+
+        if (!file) {
+            std::cerr << "corpus write failed at board " << offsets.size() - 1 << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool CorpusWriter::close() {
+        if (!file) {
+            file.close();
+            return false;
+        }
+
+        CorpusHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.boardCount = offsets.size();
+        header.tableOffset = static_cast<std::uint64_t>(file.tellp());
+
+        file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+        if (file) {
+            file.seekp(0);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        const bool written = static_cast<bool>(file);
+        file.close();
+        if (!written || file.fail()) {
+            std::cerr << "corpus write failed" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    CorpusReader::~CorpusReader() {
+        close();
+    }
+
+    bool CorpusReader::open(const std::string& path) {
+
+        close();
+
+#if defined(_WIN32)
+        HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            std::cerr << "cannot open corpus " << path << std::endl;
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(handle, &fileSize);
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        fileHandle = handle;
+        mappingHandle = mapping;
+        if (!view) {
+            std::cerr << "cannot map corpus " << path << std::endl;
+            close();
+            return false;
+        }
+
+        data = static_cast<const unsigned char*>(view);
+        length = static_cast<std::uint64_t>(fileSize.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "cannot open corpus " << path << std::endl;
+            return false;
+        }
+
+        struct stat info{};
+        fstat(fd, &info);
+        void* view = info.st_size > 0 ? mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+
+        if (view == MAP_FAILED) {
+            std::cerr << "cannot map corpus " << path << std::endl;
+            return false;
+        }
+
+        data = static_cast<const unsigned char*>(view);
+        length = static_cast<std::uint64_t>(info.st_size);
+#endif
+
+        header = reinterpret_cast<const CorpusHeader*>(data);
+        bool valid = length >= sizeof(CorpusHeader)
+                     && std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+                     && header->version == VERSION
+                     && header->tableOffset % sizeof(std::uint64_t) == 0
+                     && header->tableOffset <= length
+                     && header->boardCount <= (length - header->tableOffset) / sizeof(std::uint64_t);
+
+        if (valid) {
+            table = reinterpret_cast<const std::uint64_t*>(data + header->tableOffset);
+            for (std::uint64_t board = 0; valid && board < header->boardCount; board++) {
+                valid = validRecord(table[board]);
+            }
+        }
+
+        if (!valid) {
+            std::cerr << "not a corpus file " << path << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // the record and its mine words lie inside the mapping and describe a board Grid can hold
+    bool CorpusReader::validRecord(std::uint64_t offset) const {
+        if (offset % sizeof(std::uint64_t) != 0 || offset < sizeof(CorpusHeader)
+            || length < sizeof(BoardRecord) || offset > length - sizeof(BoardRecord)) {
+            return false;
+        }
+
+        const BoardRecord& record = *reinterpret_cast<const BoardRecord*>(data + offset);
+        if (record.width == 0 || record.height == 0 || record.width > MAX_SIDE || record.height > MAX_SIDE
+            || record.mineNum >= static_cast<std::uint64_t>(record.width) * record.height
+            || record.safeX >= record.width || record.safeY >= record.height) {
+            return false;
+        }
+
+        const std::uint64_t words = mineWordCount(record.width, record.height);
+        return words <= (length - offset - sizeof(BoardRecord)) / sizeof(std::uint64_t);
+    }
+
+    void CorpusReader::close() {
+
+#if defined(_WIN32)
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        if (fileHandle) {
+            CloseHandle(fileHandle);
+        }
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+#else
+        if (data) {
+            munmap(const_cast<unsigned char*>(data), length);
+        }
+#endif
+
+        data = nullptr;
+        length = 0;
+        header = nullptr;
+        table = nullptr;
+    }
+
+    const BoardRecord& CorpusReader::getRecord(std::uint64_t board) const {
+        return *reinterpret_cast<const BoardRecord*>(data + table[board]);
+    }
+
+    const std::uint64_t* CorpusReader::getMineWords(std::uint64_t board) const {
+        return reinterpret_cast<const std::uint64_t*>(data + table[board] + sizeof(BoardRecord));
+    }
+
+    void CorpusReader::load(std::uint64_t board, Grid::Grid& grid) const {
+        const BoardRecord& record = getRecord(board);
+        grid.loadBoard(record.height, record.width, record.mineNum, record.safeX, record.safeY, record.seed, getMineWords(board));
+    }
+
+} // Corpus
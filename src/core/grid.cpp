@@ -6,262 +6,409 @@
 
 #include <chrono>
 #include <random>
-#include <numeric>
-#include <queue>
-#include <raylib.h>
+#include <thread>
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 
 namespace Grid {
 
-    Grid::Grid(int height, int width, int mineNum) {
+    // below this many cells spawning threads costs more than the count itself
+    static constexpr size_t PARALLEL_ADJACENCY_CELLS = 1 << 22;
+
+    // journal never restarts below this many entries, small boards always read incrementally
+    static constexpr size_t JOURNAL_MIN_LIMIT = 1 << 16;
+
+    // unbiased value in [0, bound), std distributions are not portable between standard libraries
+    static std::uint64_t boundedRandom(std::mt19937_64& gen, std::uint64_t bound) {
+        const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+        const std::uint64_t limit = max - max % bound;
+
+        std::uint64_t value = gen();
+        while (value >= limit) {
+            value = gen();
+        }
+        return value % bound;
+    }
+
+    // steady clock unless a caller injects one
+    static double steadySeconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    Grid::Grid(int height, int width, int mineNum) : clock(steadySeconds) {
         initializeEmptyGrid(height, width, mineNum);
     }
 
-    Grid::Grid(int height, int width, float mineDensity) {
+    Grid::Grid(int height, int width, float mineDensity) : clock(steadySeconds) {
         initializeEmptyGrid(height, width, height * width * mineDensity);
     }
 
     // empty grid before safexy and bombs are placed
     void Grid::initializeEmptyGrid(int height, int width, int mineNum) {
 
-        this->cells.assign(height, std::vector<Cell>(width));
-
         //initialize board unrevealed unflagged empty cells
-        for (int row = 0; row < height; row++) {
-            for (int col = 0; col < width; col++) {
-                this->cells[row][col].content = CELL_EMPTY;
-                this->cells[row][col].renderTile = Tile::TILE_BLANK;
-                this->cells[row][col].revealed = false;
-                this->cells[row][col].flagged = false;
-                this->cells[row][col].adjacentMines = 0;
-            }
-        }
+        this->cells.assign(static_cast<size_t>(height) * width, 0);
+        this->minePlane.resize(width, height);
+        this->revealedPlane.resize(width, height);
+        this->flaggedPlane.resize(width, height);
+        this->openPlane.resize(width, height);
+        this->regionPlane.resize(width, height);
 
         this->metadata.height = height;
         this->metadata.width = width;
         this->metadata.mineNum = mineNum;
+        this->safeCellsLeft = height * width - mineNum;
 
     }
 
-    // fill grid with mines from safexy and prng
+    // fill grid with mines from safexy and a clock derived seed
     void Grid::generateGrid(int safeX, int safeY) {
+        generateGrid(safeX, safeY, generatePrng());
+    }
 
-        // reset grid on multiboard runs
-        initializeEmptyGrid(this->metadata.height, this->metadata.width, this->metadata.mineNum);
-
-        this->timeElapsed = 0.0f;
-        this->startTime = GetTime();
-        this->metadata.time = 0.0f;
-        this->metadata.safeX = safeX;
-        this->metadata.safeY = safeY;
-        this->metadata.gridState = ONGOING;
+    // fill grid with mines from safexy and seed, the same seed gives the same board everywhere
+    void Grid::generateGrid(int safeX, int safeY, std::uint64_t seed) {
 
-        generatePrng();
+        beginBoard(safeX, safeY, seed);
 
         // populate grid with mines
-        int totalCells = this->metadata.width * this->metadata.height;
-        int safeFlat = safeY * this->metadata.width + safeX;
-        std::vector<int> idx(totalCells - 1);
-        std::iota(idx.begin(), idx.end(), 0);
-        std::mt19937_64 gen(this->metadata.prng);
-        for (int i = 0; i < this->metadata.mineNum; ++i) {
-            std::uniform_int_distribution<int> dist(i, static_cast<int>(idx.size()) - 1);
-            int j = dist(gen);
-            std::swap(idx[i], idx[j]);
-
-            int flat = (idx[i] >= safeFlat) ? idx[i] + 1 : idx[i];
-            int y = flat / this->metadata.width, x = flat % metadata.width;
-            this->cells[y][x].content = CELL_MINE;
+        // floyd's sampling over every cell but the safe one, the mine plane doubles as the chosen set
+        // so time and extra memory scale with the mine count instead of the cell count
+        const std::int64_t width = this->metadata.width;
+        const std::int64_t candidates = width * this->metadata.height - 1;
+        const std::int64_t safeFlat = safeY * width + safeX;
+
+        auto toFlat = [safeFlat](std::int64_t candidate) {
+            return (candidate >= safeFlat) ? candidate + 1 : candidate;
+        };
+
+        std::mt19937_64 gen(seed);
+        for (std::int64_t j = candidates - this->metadata.mineNum; j < candidates; ++j) {
+            std::int64_t flat = toFlat(static_cast<std::int64_t>(boundedRandom(gen, j + 1)));
+            if (this->minePlane.test(static_cast<int>(flat % width), static_cast<int>(flat / width))) {
+                flat = toFlat(j);
+            }
+            this->minePlane.set(static_cast<int>(flat % width), static_cast<int>(flat / width));
+        }
+
+        finishBoard();
+
+    }
+
+    void Grid::loadBoard(int height, int width, int mineNum, int safeX, int safeY, std::uint64_t seed, const std::uint64_t* mineWords) {
+
+        this->metadata.height = height;
+        this->metadata.width = width;
+        this->metadata.mineNum = mineNum;
+        beginBoard(safeX, safeY, seed);
+
+        const int rowWords = this->minePlane.getRowWords();
+        for (int y = 0; y < height; ++y) {
+            std::copy(mineWords + static_cast<size_t>(y) * rowWords, mineWords + static_cast<size_t>(y + 1) * rowWords, this->minePlane.row(y));
+            this->minePlane.row(y)[rowWords - 1] &= this->minePlane.getTailMask();
         }
 
-        // calculate adjacency tiles
+        finishBoard();
+
+    }
+
+    void Grid::saveMines(std::uint64_t* mineWords) const {
+        const int rowWords = this->minePlane.getRowWords();
         for (int y = 0; y < this->metadata.height; ++y) {
-            for (int x = 0; x < this->metadata.width; ++x) {
-                if (cells[y][x].content == CELL_MINE)
-                    continue;
-
-                int count = 0;
-                for (int dy = -1; dy <= 1; ++dy)
-                    for (int dx = -1; dx <= 1; ++dx) {
-                        int nx = x + dx;
-                        int ny = y + dy;
-                        if (nx >= 0 && nx < this->metadata.width && ny >= 0 && ny < this->metadata.height &&
-                            cells[ny][nx].content == CELL_MINE)
-                            ++count;
-                    }
-
-                cells[y][x].adjacentMines = count;
+            std::copy(this->minePlane.row(y), this->minePlane.row(y) + rowWords, mineWords + static_cast<size_t>(y) * rowWords);
+        }
+    }
 
-            }
+    void Grid::swapBoard(Grid& other) {
+
+        std::swap(this->metadata, other.metadata);
+        std::swap(this->cells, other.cells);
+        std::swap(this->safeCellsLeft, other.safeCellsLeft);
+        std::swap(this->minePlane, other.minePlane);
+        std::swap(this->revealedPlane, other.revealedPlane);
+        std::swap(this->flaggedPlane, other.flaggedPlane);
+        std::swap(this->openPlane, other.openPlane);
+        std::swap(this->regionPlane, other.regionPlane);
+
+        // neither journal describes the board it now holds
+        for (Grid* grid : {this, &other}) {
+            grid->journal.clear();
+            grid->journalLimit = std::max<size_t>(JOURNAL_MIN_LIMIT, grid->cells.size() / 8);
+            grid->journalPaused = false;
+            grid->epoch++;
+            grid->mutationCount++;
         }
 
+        this->timeElapsed = 0.0f;
+        this->startTime = this->clock();
+        this->metadata.time = 0.0f;
+
     }
 
-    // bfs fill reveal
-    void Grid::reveal(int x, int y) {
+    // reset grid on multiboard runs
+    void Grid::beginBoard(int safeX, int safeY, std::uint64_t seed) {
 
-        if (validateCoordinates(x, y)) {
+        initializeEmptyGrid(this->metadata.height, this->metadata.width, this->metadata.mineNum);
 
-            Cell& firstCell = this->cells[y][x];
+        this->timeElapsed = 0.0f;
+        this->startTime = this->clock();
+        this->metadata.time = 0.0f;
+        this->metadata.safeX = safeX;
+        this->metadata.safeY = safeY;
+        this->metadata.gridState = ONGOING;
+        this->metadata.prng = seed;
 
-            // ignore
-            if (firstCell.revealed || firstCell.flagged) {
-                return;
-            }
+        std::ostringstream seedStream;
+        seedStream << std::hex << std::setw(16) << std::setfill('0') << seed;
+        this->metadata.seed64 = seedStream.str();
 
-            if (firstCell.content == CELL_MINE) {
-                endRevealAll(x, y);
-            }
+        this->journal.clear();
+        this->journalLimit = std::max<size_t>(JOURNAL_MIN_LIMIT, this->cells.size() / 8);
+        this->journalPaused = false;
+        this->epoch++;
 
-            std::queue<std::pair<int, int>> toReveal;
-            toReveal.push({x, y});
+    }
 
-            while (!toReveal.empty()) {
-                auto [x, y] = toReveal.front();
-                toReveal.pop();
+    // mines are in minePlane, derive everything else
+    void Grid::finishBoard() {
 
-                if (x < 0 || x >= this->metadata.width || y < 0 || y >= this->metadata.height)
-                    continue;
+        // calculate adjacency tiles word parallel, mine cells keep only their flag
+        // large boards split the rows into bands, one per hardware thread
+        const bool large = this->cells.size() >= PARALLEL_ADJACENCY_CELLS;
+        Bitboard::countNeighbors(this->minePlane, this->cells.data(), &this->openPlane,
+                                 large ? std::max(std::thread::hardware_concurrency(), 1u) : 1u);
+        this->minePlane.forEachSet([this](int x, int y) {
+            this->cells[index(x, y)] = CellBits::MINE;
+        });
 
-                Cell& cell = cells[y][x];
-                if (cell.revealed || cell.flagged)
-                    continue;
+    }
 
-                cell.revealed = true;
+    // bfs fill reveal
+    void Grid::reveal(int x, int y) {
+        if (validateCoordinates(x, y)) {
+            const int flat = index(x, y);
+            revealMany(std::span(&flat, 1));
+        }
+    }
 
-                if (cell.adjacentMines == 0 && cell.content != CELL_MINE) {
-                    cell.renderTile = Tile::TILE_REVEALED;
-                    for (int dy = -1; dy <= 1; ++dy)
-                        for (int dx = -1; dx <= 1; ++dx)
-                            if (dx != 0 || dy != 0)
-                                toReveal.push({x + dx, y + dy});
-                } else {
-                    cell.renderTile = static_cast<Tile::TileId>(Tile::TILE_1 + (cell.adjacentMines - 1));
-                }
+    void Grid::revealMany(std::span<const int> targets) {
+
+        const int width = metadata.width;
+        const int cellCount = width * metadata.height;
 
+        // numbers are marked straight away, zeros seed one fill, the first mine stops the rest
+        floodSeeds.clear();
+        int hit = -1;
+        for (int flat : targets) {
+            if (flat < 0 || flat >= cellCount) {
+                continue;
             }
+            const PackedCell cell = cells[flat];
+            if (cell & (CellBits::REVEALED | CellBits::FLAGGED)) {
+                continue;
+            }
+            if (cell & CellBits::MINE) {
+                hit = flat;
+                break;
+            }
+            if ((cell & CellBits::ADJACENT_MASK) != 0) {
+                markRevealed(flat % width, flat / width);
+            } else {
+                floodSeeds.emplace_back(flat % width, flat / width);
+            }
+        }
 
-            getWinCondition();
+        // zero regions expand through open cells and stop at numbers, flags and revealed cells
+        if (!floodSeeds.empty()) {
+            auto [rowBegin, rowEnd] = Bitboard::floodFill(this->regionPlane, this->floodSeeds, this->openPlane,
+                                                          this->revealedPlane, this->flaggedPlane, this->floodScratch);
 
+            this->regionPlane.forEachSet(rowBegin, rowEnd, [this](int cx, int cy) {
+                markRevealed(cx, cy);
+            });
+            this->regionPlane.clearRows(rowBegin, rowEnd);
         }
 
+        if (hit >= 0) {
+            endRevealAll(hit % width, hit / width);
+        } else {
+            getWinCondition();
+        }
     }
 
     void Grid::flag(int x, int y) {
         if (validateCoordinates(x, y)) {
-            if (cells[y][x].revealed == false) {
-                cells[y][x].flagged = (cells[y][x].flagged == true) ? false : true;
-                cells[y][x].renderTile = (cells[y][x].flagged == true) ? Tile::TILE_FLAG : Tile::TILE_BLANK;
+            const PackedCell cell = cells[index(x, y)];
+            if (!(cell & CellBits::REVEALED)) {
+                writeCell(index(x, y), cell ^ CellBits::FLAGGED);
+                flaggedPlane.flip(x, y);
             }
         }
     }
 
     void Grid::chord(int x, int y) {
         if (validateCoordinates(x, y)) {
-            int flagCount = 0;
-
-            // Count flags around
-            for (int dy = -1; dy <= 1; ++dy) {
-                for (int dx = -1; dx <= 1; ++dx) {
-                    int nx = x + dx;
-                    int ny = y + dy;
-                    if (dx == 0 && dy == 0) continue;
-                    if (nx >= 0 && nx < this->metadata.width && ny >= 0 && ny < this->metadata.height) {
-                        if (cells[ny][nx].flagged)
-                            flagCount++;
-                    }
-                }
+            pendingReveals.clear();
+            addChordTargets(index(x, y));
+            revealMany(pendingReveals);
+        }
+    }
+
+    // hidden unflagged neighbours of a revealed number whose flags match it
+    void Grid::addChordTargets(int flat) {
+        if (!(cells[flat] & CellBits::REVEALED)) {
+            return;
+        }
+
+        const int x = flat % metadata.width;
+        const int y = flat / metadata.width;
+        const int yBegin = std::max(y - 1, 0);
+        const int yEnd = std::min(y + 1, metadata.height - 1);
+        const int xBegin = std::max(x - 1, 0);
+        const int xEnd = std::min(x + 1, metadata.width - 1);
+
+        int flagCount = 0;
+        for (int ny = yBegin; ny <= yEnd; ++ny) {
+            for (int nx = xBegin; nx <= xEnd; ++nx) {
+                flagCount += (cells[index(nx, ny)] & CellBits::FLAGGED) ? 1 : 0;
             }
+        }
+        if (flagCount != (cells[flat] & CellBits::ADJACENT_MASK)) {
+            return;
+        }
 
-            if (flagCount == cells[y][x].adjacentMines) {
-                // Reveal surrounding cells that are not flagged
-                for (int dy = -1; dy <= 1; ++dy) {
-                    for (int dx = -1; dx <= 1; ++dx) {
-                        int nx = x + dx;
-                        int ny = y + dy;
-                        if (dx == 0 && dy == 0) continue;
-                        if (nx >= 0 && nx < this->metadata.width && ny >= 0 && ny < this->metadata.height) {
-                            Cell& neighbor = cells[ny][nx];
-                            if (!neighbor.flagged && !neighbor.revealed) {
-                                reveal(nx, ny);
-                            }
-                        }
-                    }
+        for (int ny = yBegin; ny <= yEnd; ++ny) {
+            for (int nx = xBegin; nx <= xEnd; ++nx) {
+                if (!(cells[index(nx, ny)] & (CellBits::FLAGGED | CellBits::REVEALED))) {
+                    pendingReveals.push_back(index(nx, ny));
                 }
             }
         }
     }
 
+    void Grid::apply(const ActionBatch& actions) {
+        if (actions.empty() || metadata.gridState != ONGOING) {
+            return;
+        }
+
+        const int width = metadata.width;
+        const int cellCount = width * metadata.height;
+
+        for (int flat : actions.flags) {
+            if (flat >= 0 && flat < cellCount && !(cells[flat] & (CellBits::REVEALED | CellBits::FLAGGED))) {
+                writeCell(flat, cells[flat] | CellBits::FLAGGED);
+                flaggedPlane.set(flat % width, flat / width);
+            }
+        }
+
+        // chords become plain reveals, counted against the flags just placed
+        pendingReveals.assign(actions.reveals.begin(), actions.reveals.end());
+        for (int flat : actions.chords) {
+            if (flat >= 0 && flat < cellCount) {
+                addChordTargets(flat);
+            }
+        }
+        revealMany(pendingReveals);
+    }
+
     void Grid::updateTimer() {
-        const double now = GetTime();
+        const double now = clock();
         timeElapsed = static_cast<float>(now - startTime);
         metadata.time = timeElapsed;
     }
 
+    void Grid::setClock(Clock clock) {
+        this->clock = std::move(clock);
+    }
+
     bool Grid::validateCoordinates(int x, int y) {
         return (x >= 0 && x < this->metadata.width) && (y >= 0 && y < this->metadata.height);
     }
 
-    void Grid::generatePrng() {
-
-        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-    std::chrono::system_clock::now().time_since_epoch()).count();
-        std::ostringstream saltStream;
-        saltStream << std::hex << ns;
+    // clock derived seed for boards nobody asked to reproduce
+    std::uint64_t Grid::generatePrng() {
 
-        std::string salt = saltStream.str();
+        std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
 
-        std::string fullKey = std::format("{}", salt);
-        std::hash<std::string> hasher;
-        this->metadata.prng = hasher(fullKey);
+        // splitmix64 finaliser so close timestamps give unrelated seeds
+        ns += 0x9E3779B97F4A7C15ull;
+        ns = (ns ^ (ns >> 30)) * 0xBF58476D1CE4E5B9ull;
+        ns = (ns ^ (ns >> 27)) * 0x94D049BB133111EBull;
+        return ns ^ (ns >> 31);
     }
 
     bool Grid::getWinCondition() {
-        for (int y = 0; y < this->metadata.height; ++y) {
-            for (int x = 0; x < this->metadata.width; ++x) {
-                const Cell& cell = cells[y][x];
-                if (cell.content == CELL_EMPTY && (cell.renderTile == Tile::TILE_BLANK || cell.renderTile == Tile::TILE_FLAG || cell.renderTile == Tile::TILE_QUESTION)) {
-                    return false;
-                }
-            }
+        if (safeCellsLeft > 0) {
+            return false;
         }
         metadata.gridState = FINISHED_WIN;
         return true;
     }
 
     Cell Grid::getCellProperties(int x, int y) {
-        return cells[y][x];
+        const PackedCell packed = cells[index(x, y)];
+
+        Cell cell;
+        cell.content = (packed & CellBits::MINE) ? CELL_MINE : CELL_EMPTY;
+        cell.renderTile = renderTileOf(packed, metadata.gridState);
+        cell.revealed = packed & CellBits::REVEALED;
+        cell.flagged = packed & CellBits::FLAGGED;
+        cell.adjacentMines = packed & CellBits::ADJACENT_MASK;
+        return cell;
     }
 
 
     void Grid::endRevealAll(int hitx, int hity) {
-        for (int y = 0; y < this->metadata.height; ++y) {
-            for (int x = 0; x < this->metadata.width; ++x) {
-                Cell& cell = cells[y][x];
-                if (cell.content == CELL_MINE) {
-                    if (cell.flagged) {
-                        continue;
-                    }
-
-                    if (!cell.revealed) {
-                        cell.revealed = true;
-                        cell.renderTile = Tile::TILE_MINE_REVEALED;
-                    }
-                } else if (cell.flagged) {
-                    cell.renderTile = Tile::TILE_MINE_WRONG;
-                }
+        // flagged non mines are rendered as wrong once the state is FINISHED_LOSE
+        minePlane.forEachSet([this](int x, int y) {
+            if (!(cells[index(x, y)] & (CellBits::FLAGGED | CellBits::REVEALED))) {
+                markRevealed(x, y);
             }
-        }
-        cells[hity][hitx].renderTile = Tile::TILE_MINE_HIT;
+        });
+        writeCell(index(hitx, hity), cells[index(hitx, hity)] | CellBits::HIT);
         metadata.gridState = FINISHED_LOSE;
 
     }
 
-    GridMetadata Grid::getMetadata() {
-        return this->metadata;
+    // callers only pass hidden cells
+    void Grid::markRevealed(int x, int y) {
+        const PackedCell cell = cells[index(x, y)];
+        if (!(cell & CellBits::MINE)) {
+            --safeCellsLeft;
+        }
+        writeCell(index(x, y), cell | CellBits::REVEALED);
+        revealedPlane.set(x, y);
+    }
+
+    void Grid::writeCell(int flat, PackedCell after) {
+        if (!journalPaused && journal.size() >= journalLimit) {
+            journal.clear();
+            journalPaused = true;
+            epoch++;
+        }
+
+        if (!journalPaused) {
+            journal.push_back({static_cast<std::uint32_t>(flat), cells[flat], after});
+        }
+        cells[flat] = after;
+        mutationCount++;
     }
 
-    std::vector<std::vector<Cell>>& Grid::getCells() {
-        return this->cells;
+    bool Grid::readJournal(JournalCursor& cursor, std::span<const CellDelta>& changes) {
+        journalPaused = false;
+
+        if (cursor.epoch != epoch) {
+            cursor = {epoch, journal.size()};
+            changes = {};
+            return false;
+        }
+
+        changes = std::span<const CellDelta>(journal).subspan(cursor.position);
+        cursor.position = journal.size();
+        return true;
     }
 
 
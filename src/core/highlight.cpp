@@ -0,0 +1,100 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/core/highlight.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace Highlight {
+
+    static constexpr std::uint64_t TRAIL_CAPACITY = 4096;
+
+    // a seqlock per slot, sequence is the tile's index plus one once written and 0 while it is being written
+    // fields are atomics so a reader racing an overwrite reads stale values rather than undefined ones
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<int> x{0};
+        std::atomic<int> y{0};
+        std::atomic<std::chrono::steady_clock::rep> spawn{0};
+    };
+
+    static Slot ring[TRAIL_CAPACITY];
+
+    // producer owned, index of the next tile and the first tile still shown after a reset
+    static std::atomic<std::uint64_t> head = 0;
+    static std::atomic<std::uint64_t> clearedBefore = 0;
+
+    // consumer owned, everything below has expired
+    static std::uint64_t tail = 0;
+
+    static std::atomic<int> boundsWidth = 0;
+    static std::atomic<int> boundsHeight = 0;
+
+    void setBounds(int width, int height) {
+        boundsWidth.store(width, std::memory_order_relaxed);
+        boundsHeight.store(height, std::memory_order_relaxed);
+    }
+
+    void queueHighlightTile(int x, int y) {
+
+        if (x < 0 || x >= boundsWidth.load(std::memory_order_relaxed) || y < 0 || y >= boundsHeight.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        const std::uint64_t index = head.load(std::memory_order_relaxed);
+        Slot& slot = ring[index % TRAIL_CAPACITY];
+
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.x.store(x, std::memory_order_relaxed);
+        slot.y.store(y, std::memory_order_relaxed);
+        slot.spawn.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    void resetHighlightTiles() {
+        clearedBefore.store(head.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    void forEachHighlightTile(std::chrono::milliseconds lifetime, const std::function<void(const HighlightedTile&)>& f) {
+
+        const std::uint64_t end = head.load(std::memory_order_acquire);
+        const std::uint64_t oldest = end > TRAIL_CAPACITY ? end - TRAIL_CAPACITY : 0;
+        tail = std::max({tail, oldest, clearedBefore.load(std::memory_order_acquire)});
+
+        const auto now = std::chrono::steady_clock::now();
+        bool expiring = true;
+        for (std::uint64_t index = tail; index < end; index++) {
+            const Slot& slot = ring[index % TRAIL_CAPACITY];
+
+            const std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            HighlightedTile tile{
+                slot.x.load(std::memory_order_relaxed),
+                slot.y.load(std::memory_order_relaxed),
+                std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(slot.spawn.load(std::memory_order_relaxed)))
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // overwritten or mid write, the producer has lapped this tile
+            if (before != index + 1 || slot.sequence.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+
+            // spawn times only grow, the expired tiles are a prefix
+            if (now - tile.spawn > lifetime) {
+                if (expiring) {
+                    tail = index + 1;
+                }
+                continue;
+            }
+            expiring = false;
+            f(tile);
+        }
+    }
+
+} // Highlight
@@ -0,0 +1,126 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/core/overview.h>
+
+namespace Grid {
+
+    void BoardOverview::resize(int width, int height) {
+        this->width = width;
+        this->height = height;
+        levels.clear();
+
+        for (int blockTiles = BLOCK; ; blockTiles *= 2) {
+            Level level;
+            level.blockTiles = blockTiles;
+            level.blocksX = (width + blockTiles - 1) / blockTiles;
+            level.blocksY = (height + blockTiles - 1) / blockTiles;
+
+            const size_t blocks = static_cast<size_t>(level.blocksX) * level.blocksY;
+            level.revealed = std::make_unique<std::atomic<std::uint32_t>[]>(blocks);
+            level.flagged = std::make_unique<std::atomic<std::uint32_t>[]>(blocks);
+            level.mines = std::make_unique<std::atomic<std::uint32_t>[]>(blocks);
+            levels.push_back(std::move(level));
+
+            if (blocks <= 1) {
+                break;
+            }
+        }
+
+        stamps.clear();
+        for (int scale = 0; scale < BLOCK_SCALE + static_cast<int>(levels.size()); scale++) {
+            const int regionTiles = REGION << scale;
+            Stamps s;
+            s.regionsX = (width + regionTiles - 1) / regionTiles;
+            s.regionsY = (height + regionTiles - 1) / regionTiles;
+            s.changed = std::make_unique<std::atomic<std::uint64_t>[]>(static_cast<size_t>(s.regionsX) * s.regionsY);
+            stamps.push_back(std::move(s));
+        }
+
+        rebuiltAt.store(changes.fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_relaxed);
+    }
+
+    // level 0 straight from the cells, every level above sums its 2x2 children
+    void BoardOverview::rebuild(std::span<const PackedCell> cells) {
+
+        for (Level& level : levels) {
+            const size_t blocks = static_cast<size_t>(level.blocksX) * level.blocksY;
+            for (size_t i = 0; i < blocks; i++) {
+                level.revealed[i].store(0, std::memory_order_relaxed);
+                level.flagged[i].store(0, std::memory_order_relaxed);
+                level.mines[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        Level& base = levels.front();
+        for (int y = 0; y < height; y++) {
+            const size_t row = static_cast<size_t>(y / BLOCK) * base.blocksX;
+            for (int x = 0; x < width; x++) {
+                const PackedCell cell = cells[static_cast<size_t>(y) * width + x];
+                const size_t block = row + x / BLOCK;
+                if (cell & CellBits::REVEALED) {
+                    base.revealed[block].fetch_add(1, std::memory_order_relaxed);
+                }
+                if (cell & CellBits::FLAGGED) {
+                    base.flagged[block].fetch_add(1, std::memory_order_relaxed);
+                }
+                if (cell & CellBits::MINE) {
+                    base.mines[block].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        for (size_t l = 1; l < levels.size(); l++) {
+            const Level& child = levels[l - 1];
+            Level& parent = levels[l];
+            for (int by = 0; by < child.blocksY; by++) {
+                for (int bx = 0; bx < child.blocksX; bx++) {
+                    const size_t from = static_cast<size_t>(by) * child.blocksX + bx;
+                    const size_t to = static_cast<size_t>(by / 2) * parent.blocksX + bx / 2;
+                    parent.revealed[to].fetch_add(child.revealed[from].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    parent.flagged[to].fetch_add(child.flagged[from].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    parent.mines[to].fetch_add(child.mines[from].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+            }
+        }
+
+        rebuiltAt.store(changes.fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_relaxed);
+    }
+
+    void BoardOverview::apply(const CellDelta& delta) {
+        const PackedCell changed = delta.before ^ delta.after;
+        if (!(changed & (CellBits::REVEALED | CellBits::FLAGGED | CellBits::MINE))) {
+            return;
+        }
+
+        const int x = static_cast<int>(delta.index % width);
+        const int y = static_cast<int>(delta.index / width);
+
+        // unsigned adds wrap, adding the all ones pattern takes one away
+        auto step = [&](PackedCell bit) -> std::uint32_t {
+            if (!(changed & bit)) {
+                return 0;
+            }
+            return (delta.after & bit) ? 1u : ~0u;
+        };
+        const std::uint32_t revealed = step(CellBits::REVEALED);
+        const std::uint32_t flagged = step(CellBits::FLAGGED);
+        const std::uint32_t mines = step(CellBits::MINE);
+
+        for (Level& level : levels) {
+            const size_t block = static_cast<size_t>(y / level.blockTiles) * level.blocksX + x / level.blockTiles;
+            level.revealed[block].fetch_add(revealed, std::memory_order_relaxed);
+            level.flagged[block].fetch_add(flagged, std::memory_order_relaxed);
+            level.mines[block].fetch_add(mines, std::memory_order_relaxed);
+        }
+
+        // the change count moves after the counts, readers that load it first see them
+        const std::uint64_t stamp = changes.fetch_add(1, std::memory_order_acq_rel) + 1;
+        for (int scale = 0; scale < static_cast<int>(stamps.size()); scale++) {
+            Stamps& s = stamps[scale];
+            s.changed[static_cast<size_t>(y / (REGION << scale)) * s.regionsX + x / (REGION << scale)].store(stamp, std::memory_order_relaxed);
+        }
+    }
+
+} // Grid
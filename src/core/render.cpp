@@ -7,25 +7,71 @@
 #include <raylib.h>
 
 #include "dansweeperml/core/grid.h"
+#include "dansweeperml/core/highlight.h"
 #include "dansweeperml/core/tile.h"
 #include <algorithm>
 #include <cassert>
-#include <deque>
+#include <cstdint>
 #include <shared_mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace Render {
 
     static Texture2D textureTileset;
     static Camera2D* camera = nullptr;
-    static Grid::Grid* grid = nullptr;
+    static Grid::SnapshotPublisher* snapshots = nullptr;
+    static Grid::ChunkedGrid* chunkedGrid = nullptr;
     static Grid::GridMetadata gridMetadata;
 
-    static std::deque<HighlightedTile> highlightedTiles;
+    // flat boards are drawn through cached textures of CHUNK x CHUNK tiles, composited every frame
+    // a chunk is redrawn only where its tiles changed, or whole when it is new or the board was replaced
+    static constexpr int CHUNK = Grid::DirtyTiles::CHUNK;
+    static constexpr size_t MAX_CHUNK_TEXTURES = 128;
+
+    struct ChunkTexture {
+        RenderTexture2D target;
+        bool valid = false;
+        std::uint64_t lastUsed = 0;
+    };
+
+    static std::unordered_map<std::int64_t, ChunkTexture> chunkTextures;
+    static std::vector<std::pair<int, int>> dirtyTiles;
+    static std::uint64_t frame = 0;
+
+    // below this many screen pixels per tile flat boards are drawn from the overview
+    // a texel spans the fewest tiles that still cover a screen pixel, one tile right at the switch
+    static constexpr float OVERVIEW_TILE_PIXELS = 4.0f;
+    static constexpr int OVERVIEW_REGION = Grid::BoardOverview::REGION;
+    static constexpr size_t MAX_OVERVIEW_TEXTURES = 1024;
+
+    // OVERVIEW_REGION x OVERVIEW_REGION texels of one scale, recoloured once a change lands in its region after builtAt
+    struct OverviewTexture {
+        Texture2D texture;
+        std::uint64_t builtAt = 0;
+        std::uint64_t lastUsed = 0;
+    };
+
+    static std::unordered_map<std::int64_t, OverviewTexture> overviewTextures;
+    static std::vector<Color> overviewPixels;
+
     static std::chrono::milliseconds highlightLifetime{500};
-    static size_t highlightedTilesMaxSizeTrail = 4096;
-    static std::mutex highlightedTilesMtx;
     static bool drawHighlight = true;
 
+    static void unloadChunkTextures() {
+        for (auto& [key, chunk] : chunkTextures) {
+            UnloadRenderTexture(chunk.target);
+        }
+        chunkTextures.clear();
+    }
+
+    static void unloadOverviewTextures() {
+        for (auto& [key, region] : overviewTextures) {
+            UnloadTexture(region.texture);
+        }
+        overviewTextures.clear();
+    }
+
     void Render::loadTexture() {
         Image texture = LoadImage("../resources/texture.png");
         textureTileset = LoadTextureFromImage(texture);
@@ -34,16 +80,258 @@ namespace Render {
 
     void Render::unloadTexture() {
         UnloadTexture(textureTileset);
+        unloadChunkTextures();
+        unloadOverviewTextures();
     }
 
-    void initializeRender(Camera2D& c, Grid::Grid* g) {
+    static void drawTile(int tileID, int x, int y) {
+        int srcX = (tileID % Tile::TILE_ROW_COL) * Tile::TILE_SIZE;
+        int srcY = (tileID / Tile::TILE_ROW_COL) * Tile::TILE_SIZE;
 
-        camera = &c;
-        grid = g;
-        gridMetadata = grid->getMetadata();
+        Rectangle srcRect = {(float)srcX, (float)srcY, (float)Tile::TILE_SIZE, (float)Tile::TILE_SIZE};
+        Vector2 pos = {(float)(x * Tile::TILE_SIZE), (float)(y * Tile::TILE_SIZE)};
+        DrawTextureRec(textureTileset, srcRect, pos, WHITE);
+    }
+
+    static std::int64_t chunkKey(int chunkX, int chunkY) {
+        return static_cast<std::int64_t>(chunkY) << 32 | static_cast<std::uint32_t>(chunkX);
+    }
+
+    // brings the visible chunk textures up to date, outside BeginMode2D since texture mode replaces the camera
+    static void updateChunkTextures(int startX, int endX, int startY, int endY) {
+
+        Grid::DirtyTiles& dirty = snapshots->getDirtyTiles();
+        if (dirty.takeAll()) {
+            for (auto& [key, chunk] : chunkTextures) {
+                chunk.valid = false;
+            }
+        }
+
+        // dirty tiles are taken before the snapshot, every one of them is current in it
+        struct Pending {
+            int chunkX;
+            int chunkY;
+            size_t begin;
+            size_t end;
+        };
+        std::vector<Pending> pending;
+        dirtyTiles.clear();
+        for (int chunkY = startY / CHUNK; chunkY <= (endY - 1) / CHUNK; chunkY++) {
+            for (int chunkX = startX / CHUNK; chunkX <= (endX - 1) / CHUNK; chunkX++) {
+                const size_t begin = dirtyTiles.size();
+                dirty.takeChunk(chunkX, chunkY, [](int x, int y) {
+                    dirtyTiles.emplace_back(x, y);
+                });
+                pending.push_back({chunkX, chunkY, begin, dirtyTiles.size()});
+            }
+        }
+
+        const std::shared_ptr<const Grid::BoardSnapshot> snapshot = snapshots->acquire();
+        const Grid::GridState gridState = snapshot->metadata.gridState;
+        const int width = snapshot->metadata.width;
+        const int height = snapshot->metadata.height;
+
+        for (const Pending& p : pending) {
+            auto [it, created] = chunkTextures.try_emplace(chunkKey(p.chunkX, p.chunkY));
+            ChunkTexture& chunk = it->second;
+            chunk.lastUsed = frame;
+            if (created) {
+                chunk.target = LoadRenderTexture(CHUNK * Tile::TILE_SIZE, CHUNK * Tile::TILE_SIZE);
+            }
+            if (chunk.valid && p.begin == p.end) {
+                continue;
+            }
+
+            // tiles are opaque, drawing over a tile replaces it
+            BeginTextureMode(chunk.target);
+            const int originX = p.chunkX * CHUNK;
+            const int originY = p.chunkY * CHUNK;
+            if (!chunk.valid) {
+                ClearBackground(BLANK);
+                for (int y = originY; y < std::min(originY + CHUNK, height); y++) {
+                    for (int x = originX; x < std::min(originX + CHUNK, width); x++) {
+                        drawTile(Grid::renderTileOf(snapshot->getPacked(x, y), gridState), x - originX, y - originY);
+                    }
+                }
+                chunk.valid = true;
+            } else {
+                for (size_t i = p.begin; i < p.end; i++) {
+                    const auto [x, y] = dirtyTiles[i];
+                    drawTile(Grid::renderTileOf(snapshot->getPacked(x, y), gridState), x - originX, y - originY);
+                }
+            }
+            EndTextureMode();
+        }
+
+        // chunks out of view the longest go first, they are rebuilt whole if they come back
+        while (chunkTextures.size() > MAX_CHUNK_TEXTURES) {
+            auto oldest = std::min_element(chunkTextures.begin(), chunkTextures.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            if (oldest->second.lastUsed == frame) {
+                break;
+            }
+            UnloadRenderTexture(oldest->second.target);
+            chunkTextures.erase(oldest);
+        }
+    }
+
+    // hidden tiles are dark and brighten as they are revealed, flags pull them towards red
+    static Color overviewColor(std::uint32_t revealedTiles, std::uint32_t flaggedTiles, std::uint32_t mines, int tiles) {
+        const float revealed = static_cast<float>(revealedTiles) / tiles;
+        const float flagged = mines > 0 ? std::min(static_cast<float>(flaggedTiles) / mines, 1.0f) : 0.0f;
+
+        const float grey = 70.0f + 130.0f * revealed;
+        return {
+            static_cast<unsigned char>(grey + (220.0f - grey) * flagged * 0.8f),
+            static_cast<unsigned char>(grey + (40.0f - grey) * flagged * 0.8f),
+            static_cast<unsigned char>(grey + (40.0f - grey) * flagged * 0.8f),
+            255
+        };
+    }
+
+    // fewest tiles per texel, as a power of two, whose texel still covers a screen pixel
+    static int overviewScale(const Grid::BoardOverview& overview) {
+        const float tilePixels = Tile::TILE_SIZE * camera->zoom;
+        int scale = 0;
+        while (scale + 1 < overview.getScaleCount() && (1 << scale) * tilePixels < 1.0f) {
+            scale++;
+        }
+        return scale;
+    }
+
+    static std::int64_t overviewKey(int scale, int regionX, int regionY) {
+        return static_cast<std::int64_t>(scale) << 56 | static_cast<std::int64_t>(regionY) << 28 | regionX;
+    }
 
-        int mapWidthPixels = grid->getMetadata().width * Tile::TILE_SIZE;
-        int mapHeightPixels = grid->getMetadata().height * Tile::TILE_SIZE;
+    // texels finer than a block count the snapshot's tiles, the rest read the overview level of their size
+    static void colorOverviewRegion(const Grid::BoardOverview& overview, const Grid::BoardSnapshot* snapshot,
+                                    int scale, int regionX, int regionY) {
+
+        const int texelTiles = 1 << scale;
+        const int width = overview.getWidth();
+        const int height = overview.getHeight();
+        overviewPixels.assign(static_cast<size_t>(OVERVIEW_REGION) * OVERVIEW_REGION, BLANK);
+
+        for (int ty = 0; ty < OVERVIEW_REGION; ty++) {
+            const int y0 = (regionY * OVERVIEW_REGION + ty) * texelTiles;
+            if (y0 >= height) {
+                break;
+            }
+            const int tilesY = std::min(texelTiles, height - y0);
+
+            for (int tx = 0; tx < OVERVIEW_REGION; tx++) {
+                const int x0 = (regionX * OVERVIEW_REGION + tx) * texelTiles;
+                if (x0 >= width) {
+                    break;
+                }
+                const int tilesX = std::min(texelTiles, width - x0);
+
+                std::uint32_t revealed = 0;
+                std::uint32_t flagged = 0;
+                std::uint32_t mines = 0;
+                if (scale < Grid::BoardOverview::BLOCK_SCALE) {
+                    for (int y = y0; y < y0 + tilesY; y++) {
+                        for (int x = x0; x < x0 + tilesX; x++) {
+                            const Grid::PackedCell cell = snapshot->getPacked(x, y);
+                            revealed += (cell & Grid::CellBits::REVEALED) != 0;
+                            flagged += (cell & Grid::CellBits::FLAGGED) != 0;
+                            mines += (cell & Grid::CellBits::MINE) != 0;
+                        }
+                    }
+                } else {
+                    const Grid::BoardOverview::Level& level = overview.getLevel(scale - Grid::BoardOverview::BLOCK_SCALE);
+                    const size_t block = static_cast<size_t>(y0 / level.blockTiles) * level.blocksX + x0 / level.blockTiles;
+                    revealed = level.revealed[block].load(std::memory_order_relaxed);
+                    flagged = level.flagged[block].load(std::memory_order_relaxed);
+                    mines = level.mines[block].load(std::memory_order_relaxed);
+                }
+                overviewPixels[static_cast<size_t>(ty) * OVERVIEW_REGION + tx] = overviewColor(revealed, flagged, mines, tilesX * tilesY);
+            }
+        }
+    }
+
+    // recolours the visible overview regions something changed in, outside BeginMode2D like the chunk textures
+    static void updateOverviewTextures(int startX, int endX, int startY, int endY) {
+
+        const Grid::BoardOverview& overview = snapshots->getOverview();
+        const int scale = overviewScale(overview);
+        const int regionTiles = OVERVIEW_REGION << scale;
+
+        // the change count comes first, every change up to it is in the counts and in any snapshot acquired after
+        const std::uint64_t changeCount = overview.getChangeCount();
+        std::shared_ptr<const Grid::BoardSnapshot> snapshot;
+        if (scale < Grid::BoardOverview::BLOCK_SCALE) {
+            snapshot = snapshots->acquire();
+            if (snapshot->metadata.width != overview.getWidth() || snapshot->metadata.height != overview.getHeight()) {
+                return;
+            }
+        }
+
+        for (int regionY = startY / regionTiles; regionY <= (endY - 1) / regionTiles; regionY++) {
+            for (int regionX = startX / regionTiles; regionX <= (endX - 1) / regionTiles; regionX++) {
+                auto [it, created] = overviewTextures.try_emplace(overviewKey(scale, regionX, regionY));
+                OverviewTexture& region = it->second;
+                region.lastUsed = frame;
+                if (created) {
+                    Image image = GenImageColor(OVERVIEW_REGION, OVERVIEW_REGION, BLANK);
+                    region.texture = LoadTextureFromImage(image);
+                    UnloadImage(image);
+                } else if (overview.getChangedAt(scale, regionX, regionY) <= region.builtAt) {
+                    continue;
+                }
+
+                colorOverviewRegion(overview, snapshot.get(), scale, regionX, regionY);
+                UpdateTexture(region.texture, overviewPixels.data());
+                region.builtAt = changeCount;
+            }
+        }
+
+        while (overviewTextures.size() > MAX_OVERVIEW_TEXTURES) {
+            auto oldest = std::min_element(overviewTextures.begin(), overviewTextures.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            if (oldest->second.lastUsed == frame) {
+                break;
+            }
+            UnloadTexture(oldest->second.texture);
+            overviewTextures.erase(oldest);
+        }
+    }
+
+    // one quad per visible region, the last row and column may hang past the board and only the covered part is drawn
+    static void drawOverview(int startX, int endX, int startY, int endY) {
+
+        const Grid::BoardOverview& overview = snapshots->getOverview();
+        const int scale = overviewScale(overview);
+        const int regionTiles = OVERVIEW_REGION << scale;
+
+        for (int regionY = startY / regionTiles; regionY <= (endY - 1) / regionTiles; regionY++) {
+            for (int regionX = startX / regionTiles; regionX <= (endX - 1) / regionTiles; regionX++) {
+                const auto it = overviewTextures.find(overviewKey(scale, regionX, regionY));
+                if (it == overviewTextures.end()) {
+                    continue;
+                }
+
+                const int originX = regionX * regionTiles;
+                const int originY = regionY * regionTiles;
+                const int tilesX = std::min(regionTiles, overview.getWidth() - originX);
+                const int tilesY = std::min(regionTiles, overview.getHeight() - originY);
+                DrawTexturePro(it->second.texture,
+                               {0, 0, static_cast<float>(tilesX) / (1 << scale), static_cast<float>(tilesY) / (1 << scale)},
+                               {static_cast<float>(originX * Tile::TILE_SIZE), static_cast<float>(originY * Tile::TILE_SIZE),
+                                static_cast<float>(tilesX * Tile::TILE_SIZE), static_cast<float>(tilesY * Tile::TILE_SIZE)},
+                               {0, 0}, 0.0f, WHITE);
+            }
+        }
+    }
+
+    static void centerCamera() {
+
+        Highlight::setBounds(gridMetadata.width, gridMetadata.height);
+
+        int mapWidthPixels = gridMetadata.width * Tile::TILE_SIZE;
+        int mapHeightPixels = gridMetadata.height * Tile::TILE_SIZE;
 
         camera->target = {mapWidthPixels / 2.0f, mapHeightPixels / 2.0f};
         camera->offset = {GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
@@ -52,9 +340,34 @@ namespace Render {
 
     }
 
+    void initializeRender(Camera2D& c, Grid::SnapshotPublisher* s) {
+
+        camera = &c;
+        snapshots = s;
+        chunkedGrid = nullptr;
+        gridMetadata = snapshots->acquire()->metadata;
+        centerCamera();
+
+    }
+
+    // solvers open unbounded boards from the middle, the camera starts there
+    void initializeRender(Camera2D& c, Grid::ChunkedGrid* g) {
+
+        camera = &c;
+        snapshots = nullptr;
+        chunkedGrid = g;
+        gridMetadata = chunkedGrid->getMetadata();
+        centerCamera();
+
+    }
+
     void Render::renderThread(bool drawTrail) {
 
-        std::shared_lock rlk(gGridMtx);
+        // chunk maps grow on the solver thread, flat boards need no lock at all
+        std::shared_lock<std::shared_mutex> rlk;
+        if (chunkedGrid) {
+            rlk = std::shared_lock(gGridMtx);
+        }
 
         drawHighlight = drawTrail;
 
@@ -62,11 +375,6 @@ namespace Render {
 
         camera->offset = {GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f};
 
-        const auto cellsRef = grid->getCells();
-
-
-        BeginMode2D(*camera);
-
         // CULLING: compute visible tile bounds
         Vector2 topLeft = GetScreenToWorld2D({0, 0}, *camera);
         Vector2 bottomRight = GetScreenToWorld2D(
@@ -77,30 +385,64 @@ namespace Render {
         int startY = std::clamp((int)(topLeft.y / Tile::TILE_SIZE), 0, gridMetadata.height - 1);
         int endY = std::clamp((int)(bottomRight.y / Tile::TILE_SIZE) + 1, 0, gridMetadata.height);
 
-        for (int y = startY; y < endY; y++) {
-            for (int x = startX; x < endX; x++) {
-                int tileID = cellsRef[y][x].renderTile;
-                int srcX = (tileID % Tile::TILE_ROW_COL) * Tile::TILE_SIZE;
-                int srcY = (tileID / Tile::TILE_ROW_COL) * Tile::TILE_SIZE;
+        frame++;
+        const bool useOverview = !chunkedGrid && Tile::TILE_SIZE * camera->zoom < OVERVIEW_TILE_PIXELS;
+        if (!chunkedGrid && !useOverview) {
+            updateChunkTextures(startX, endX, startY, endY);
+        } else if (useOverview) {
+            updateOverviewTextures(startX, endX, startY, endY);
+        }
+
+        BeginMode2D(*camera);
 
-                Rectangle srcRect = {(float)srcX, (float)srcY, (float)Tile::TILE_SIZE, (float)Tile::TILE_SIZE};
-                Vector2 pos = {(float)(x * Tile::TILE_SIZE), (float)(y * Tile::TILE_SIZE)};
-                DrawTextureRec(textureTileset, srcRect, pos, WHITE);
+        if (chunkedGrid) {
+
+            // walk the visible chunks, one map lookup per chunk instead of per cell
+            const Grid::GridState gridState = chunkedGrid->getMetadata().gridState;
+            constexpr int chunkSize = Grid::ChunkedGrid::CHUNK_SIZE;
+
+            for (int chunkY = startY / chunkSize; chunkY <= (endY - 1) / chunkSize; chunkY++) {
+                for (int chunkX = startX / chunkSize; chunkX <= (endX - 1) / chunkSize; chunkX++) {
+
+                    const Grid::PackedCell* cells = chunkedGrid->findChunk(chunkX, chunkY);
+                    const int fromY = std::max(startY, chunkY * chunkSize);
+                    const int toY = std::min(endY, (chunkY + 1) * chunkSize);
+                    const int fromX = std::max(startX, chunkX * chunkSize);
+                    const int toX = std::min(endX, (chunkX + 1) * chunkSize);
+
+                    for (int y = fromY; y < toY; y++) {
+                        for (int x = fromX; x < toX; x++) {
+                            const Grid::PackedCell cell = cells ? cells[(y % chunkSize) * chunkSize + x % chunkSize] : 0;
+                            drawTile(Grid::renderTileOf(cell, gridState), x, y);
+                        }
+                    }
+                }
             }
-        };
 
-        if (drawHighlight) {
+        } else if (useOverview) {
 
-            std::unique_lock lk(highlightedTilesMtx); // locks immediately
-            std::deque<HighlightedTile> trailCopy = highlightedTiles;
-            lk.unlock();
+            drawOverview(startX, endX, startY, endY);
 
-            const auto now = std::chrono::steady_clock::now();
-            bool needsPrune = false;
+        } else {
+
+            // one quad per visible chunk, render textures are stored upside down
+            const float chunkPixels = static_cast<float>(CHUNK * Tile::TILE_SIZE);
+            for (int chunkY = startY / CHUNK; chunkY <= (endY - 1) / CHUNK; chunkY++) {
+                for (int chunkX = startX / CHUNK; chunkX <= (endX - 1) / CHUNK; chunkX++) {
+                    const ChunkTexture& chunk = chunkTextures.at(chunkKey(chunkX, chunkY));
+                    DrawTextureRec(chunk.target.texture, {0, 0, chunkPixels, -chunkPixels},
+                                   {chunkX * chunkPixels, chunkY * chunkPixels}, WHITE);
+                }
+            }
+
+        }
+
+        if (drawHighlight) {
 
-            for (const auto& tile : trailCopy) {
+            // read in place from the solver's ring, expired tiles drop off the front
+            const auto now = std::chrono::steady_clock::now();
+            Highlight::forEachHighlightTile(highlightLifetime, [&](const Highlight::HighlightedTile& tile) {
                 auto age = now - tile.spawn;
-                if (age > highlightLifetime) { needsPrune = true; continue; }
 
                 float t = std::clamp(std::chrono::duration<float>(age) / std::chrono::duration<float>(highlightLifetime), 0.0f, 1.0f);
                 float alpha = 1.0f - t;
@@ -116,39 +458,12 @@ namespace Render {
 
                 DrawRectangleRec(r, Fade(YELLOW, alpha * 0.35f));
                 DrawRectangleLinesEx(r, 1, Fade(RED, alpha * 0.35f));
-            }
-
-            // prune deque of excess tiles
-            if (needsPrune) {
-                std::lock_guard<std::mutex> lkClear(highlightedTilesMtx);
-                const auto now2 = std::chrono::steady_clock::now();
-
-                auto& dq = highlightedTiles;
-                std::erase_if(dq, [&](const HighlightedTile& h) {
-                    return (now2 - h.spawn) > highlightLifetime;
-                });
-            }
+            });
 
         }
 
         EndMode2D();
     }
 
-    void queueHighlightTile(int x, int y) {
-
-        if (x < 0 || x >= gridMetadata.width || y < 0 || y >= gridMetadata.height) {
-            return;
-        }
-        std::lock_guard<std::mutex> lk(highlightedTilesMtx);
-        if (highlightedTiles.size() >= highlightedTilesMaxSizeTrail) {
-            highlightedTiles.pop_front();
-        }
-        highlightedTiles.push_back({x, y, std::chrono::steady_clock::now()});
-    }
-
-    void resetHighlightTiles() {
-        highlightedTiles.clear();
-    }
-
 
 } // Render
\ No newline at end of file
@@ -0,0 +1,113 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/core/snapshot.h>
+
+namespace Grid {
+
+    void DirtyTiles::resize(int width, int height) {
+        this->width = width;
+        this->height = height;
+        rowWords = (width + 63) / 64;
+        chunksX = (width + CHUNK - 1) / CHUNK;
+        chunksY = (height + CHUNK - 1) / CHUNK;
+
+        const size_t words = static_cast<size_t>(rowWords) * height;
+        const size_t chunkCount = static_cast<size_t>(chunksX) * chunksY;
+        tiles = std::make_unique<std::atomic<std::uint64_t>[]>(words);
+        chunks = std::make_unique<std::atomic<std::uint8_t>[]>(chunkCount);
+        for (size_t i = 0; i < words; i++) {
+            tiles[i].store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < chunkCount; i++) {
+            chunks[i].store(0, std::memory_order_relaxed);
+        }
+        all.store(true, std::memory_order_release);
+    }
+
+    // tile before chunk, a reader that clears the chunk flag then finds the tile
+    void DirtyTiles::mark(int x, int y) {
+        tiles[static_cast<size_t>(y) * rowWords + x / 64].fetch_or(std::uint64_t{1} << (x % 64), std::memory_order_release);
+        chunks[static_cast<size_t>(y / CHUNK) * chunksX + x / CHUNK].store(1, std::memory_order_release);
+    }
+
+    void DirtyTiles::markAll() {
+        all.store(true, std::memory_order_release);
+    }
+
+    void SnapshotPublisher::publish(Grid& grid) {
+
+        // a new board or the timer moving writes no cells, they still need a new snapshot
+        if (published && grid.getMutationCount() == publishedVersion && grid.getEpoch() == publishedEpoch && grid.getMetadata().time == publishedTime) {
+            return;
+        }
+
+        // a buffer only this publisher holds, latest and readers each keep a reference to theirs
+        Buffer* free = nullptr;
+        const std::shared_ptr<const BoardSnapshot> current = latest.load(std::memory_order_relaxed);
+        for (Buffer& buffer : buffers) {
+            if (!buffer.snapshot) {
+                buffer.snapshot = std::make_shared<BoardSnapshot>();
+                buffer.cursor = {};
+            }
+            if (buffer.snapshot != current && buffer.snapshot.use_count() == 1) {
+                free = &buffer;
+                break;
+            }
+        }
+        if (!free) {
+            return;
+        }
+
+        // the last reader let go with a release decrement, its reads are done before the writes below
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        BoardSnapshot& snapshot = *free->snapshot;
+        std::span<const CellDelta> changes;
+        if (grid.readJournal(free->cursor, changes) && snapshot.cells.size() == grid.getCells().size()) {
+            for (const CellDelta& change : changes) {
+                snapshot.cells[change.index] = change.after;
+            }
+        } else {
+            snapshot.cells.assign(grid.getCells().begin(), grid.getCells().end());
+        }
+        snapshot.metadata = grid.getMetadata();
+        snapshot.version = grid.getMutationCount();
+
+        publishedVersion = snapshot.version;
+        publishedTime = snapshot.metadata.time;
+        publishedEpoch = grid.getEpoch();
+        published = true;
+        latest.store(free->snapshot, std::memory_order_release);
+
+        // only now that the snapshot is out, see DirtyTiles
+        const GridMetadata& meta = snapshot.metadata;
+        if (!dirty.getWidth() && !dirty.getHeight()) {
+            dirty.resize(meta.width, meta.height);
+            overview.resize(meta.width, meta.height);
+        }
+        const bool sameSize = meta.width == dirty.getWidth() && meta.height == dirty.getHeight();
+
+        // a lost board draws wrong flags differently without writing them
+        const bool stateChanged = meta.gridState != publishedState;
+        publishedState = meta.gridState;
+
+        if (!grid.readJournal(dirtyCursor, changes) || !sameSize) {
+            dirty.markAll();
+            if (sameSize) {
+                overview.rebuild(grid.getCells());
+            }
+            return;
+        }
+
+        if (stateChanged) {
+            dirty.markAll();
+        }
+        for (const CellDelta& change : changes) {
+            dirty.mark(static_cast<int>(change.index) % meta.width, static_cast<int>(change.index) / meta.width);
+            overview.apply(change);
+        }
+    }
+
+} // Grid
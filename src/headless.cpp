@@ -0,0 +1,222 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <vector>
+
+#include <dansweeperml/core/corpus.h>
+#include <dansweeperml/sim/batchrunner.h>
+#include <dansweeperml/sim/tournament.h>
+#include <dansweeperml/solver/registry.h>
+
+// dansweeper_headless [--solver key[,key...]] [--boards n] [--width w] [--height h] [--mines m] [--threads t] [--seed s]
+//                     [--corpus path] [--write-corpus path] [--unbounded density] [--max-steps n] [--step-budget us]
+// more than one solver or thread runs a tournament on the work stealing pool
+// --corpus plays the boards of a corpus file, --write-corpus generates boards into one and exits
+// --unbounded plays chunked boards of that mine density until a mine or --max-steps
+// --step-budget caps the time of one solver step in microseconds, searching solvers play their best move so far
+static void usage() {
+    std::cerr << "usage: dansweeper_headless [--solver key[,key...]] [--boards n] [--width w] [--height h] [--mines m] [--threads t] [--seed s]\n";
+    std::cerr << "                           [--corpus path] [--write-corpus path] [--unbounded density] [--max-steps n] [--step-budget us]\n";
+    std::cerr << "solvers:";
+    for (const std::string& key : SolverRegistry::getSolverKeys()) {
+        std::cerr << " " << key;
+    }
+    std::cerr << std::endl;
+}
+
+static std::string boardDims(int width, int height, int mineNum) {
+    return std::to_string(width) + "x" + std::to_string(height) + ", mines: " + std::to_string(mineNum);
+}
+
+// dims are stored per board record, a corpus mixing sizes has no single line
+static std::string corpusDims(const Corpus::CorpusReader& corpus) {
+    if (corpus.size() == 0) {
+        return "none";
+    }
+
+    const Corpus::BoardRecord& first = corpus.getRecord(0);
+    for (std::uint64_t board = 1; board < corpus.size(); board++) {
+        const Corpus::BoardRecord& record = corpus.getRecord(board);
+        if (record.width != first.width || record.height != first.height || record.mineNum != first.mineNum) {
+            return "mixed";
+        }
+    }
+    return boardDims(static_cast<int>(first.width), static_cast<int>(first.height), static_cast<int>(first.mineNum));
+}
+
+static void printStats(const SolverStats& stats, const std::string& dims, double seconds) {
+    std::cout << "name: " << stats.name << "\n";
+    std::cout << "dims: " << dims << "\n";
+    std::cout << "boards run: " << stats.boardsRun << "\n";
+    std::cout << "win: " << stats.win << "\n";
+    std::cout << "lose: " << stats.lose << "\n";
+    std::cout << "winrate: " << stats.winrate << "\n";
+    std::cout << "average steps: " << stats.averageSteps << "\n";
+    std::cout << "average time: " << stats.averageTime << "\n";
+    std::cout << "boards per second: " << (seconds > 0.0 ? stats.boardsRun / seconds : 0.0) << std::endl;
+}
+
+static void printUnboundedStats(const Sim::UnboundedStats& stats, float density, double seconds) {
+    std::cout << "name: " << stats.name << "\n";
+    std::cout << "unbounded, density: " << density << "\n";
+    std::cout << "boards run: " << stats.boardsRun << "\n";
+    std::cout << "lose: " << stats.lose << "\n";
+    std::cout << "average steps: " << stats.averageSteps << "\n";
+    std::cout << "average revealed: " << stats.averageRevealed << "\n";
+    std::cout << "average chunks: " << stats.averageChunks << "\n";
+    std::cout << "peak bytes: " << stats.peakBytes << "\n";
+    std::cout << "seconds: " << seconds << std::endl;
+}
+
+static std::vector<std::string> splitKeys(const std::string& list) {
+    std::vector<std::string> keys;
+    size_t start = 0;
+    while (start <= list.size()) {
+        const size_t comma = std::min(list.find(',', start), list.size());
+        keys.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return keys;
+}
+
+int main(int argc, char** argv) {
+
+    std::string solverList = "bfsoptimized";
+    unsigned threads = 1;
+    std::string corpusPath;
+    std::string writeCorpusPath;
+    float unboundedDensity = 0.0f;
+    std::chrono::microseconds stepBudget{0};
+    Sim::BatchConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--solver") {
+            solverList = value;
+        } else if (arg == "--threads") {
+            threads = static_cast<unsigned>(std::atoi(value));
+        } else if (arg == "--boards") {
+            config.boards = std::atoi(value);
+        } else if (arg == "--width") {
+            config.width = std::atoi(value);
+        } else if (arg == "--height") {
+            config.height = std::atoi(value);
+        } else if (arg == "--mines") {
+            config.mineNum = std::atoi(value);
+        } else if (arg == "--seed") {
+            config.firstSeed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--corpus") {
+            corpusPath = value;
+        } else if (arg == "--write-corpus") {
+            writeCorpusPath = value;
+        } else if (arg == "--unbounded") {
+            unboundedDensity = std::strtof(value, nullptr);
+        } else if (arg == "--max-steps") {
+            config.maxStepsPerBoard = std::atoi(value);
+        } else if (arg == "--step-budget") {
+            stepBudget = std::chrono::microseconds(std::strtoll(value, nullptr, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    const std::vector<std::string> keys = splitKeys(solverList);
+    for (const std::string& key : keys) {
+        if (!SolverRegistry::makeSolver(key, 1)) {
+            usage();
+            return 1;
+        }
+    }
+
+    if (config.width <= 0 || config.height <= 0 || config.mineNum >= config.width * config.height) {
+        usage();
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (unboundedDensity > 0.0f) {
+        for (const std::string& key : keys) {
+            std::unique_ptr<ISolver> solver = SolverRegistry::makeSolver(key);
+            solver->setStepBudget(stepBudget);
+            const auto solverStart = std::chrono::steady_clock::now();
+            const Sim::UnboundedStats stats = Sim::runUnbounded(*solver, unboundedDensity, config);
+            printUnboundedStats(stats, unboundedDensity, std::chrono::duration<double>(std::chrono::steady_clock::now() - solverStart).count());
+        }
+        return 0;
+    }
+
+    if (!writeCorpusPath.empty()) {
+        Corpus::CorpusWriter writer;
+        if (!writer.open(writeCorpusPath)) {
+            return 1;
+        }
+
+        Grid::Grid grid(config.height, config.width, config.mineNum);
+        for (int board = 0; board < config.boards; board++) {
+            grid.generateGrid(config.width / 2, config.height / 2, config.firstSeed + board);
+            if (!writer.add(grid)) {
+                writer.close();
+                return 1;
+            }
+        }
+        return writer.close() ? 0 : 1;
+    }
+
+    if (!corpusPath.empty()) {
+        Corpus::CorpusReader corpus;
+        if (!corpus.open(corpusPath)) {
+            return 1;
+        }
+
+        const std::string dims = corpusDims(corpus);
+        for (const std::string& key : keys) {
+            std::unique_ptr<ISolver> solver = SolverRegistry::makeSolver(key);
+            solver->setStepBudget(stepBudget);
+            const auto solverStart = std::chrono::steady_clock::now();
+            const SolverStats stats = Sim::runCorpus(*solver, corpus, config.maxStepsPerBoard);
+            printStats(stats, dims, std::chrono::duration<double>(std::chrono::steady_clock::now() - solverStart).count());
+        }
+        return 0;
+    }
+
+    if (keys.size() == 1 && threads == 1) {
+        std::unique_ptr<ISolver> solver = SolverRegistry::makeSolver(keys.front());
+        solver->setStepBudget(stepBudget);
+        const SolverStats stats = Sim::runBatch(*solver, config);
+        printStats(stats, boardDims(config.width, config.height, config.mineNum), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        return 0;
+    }
+
+    Sim::TournamentConfig tournament;
+    tournament.solverKeys = keys;
+    tournament.boardConfigs.push_back({config.height, config.width, config.mineNum});
+    tournament.boardsPerConfig = config.boards;
+    tournament.firstSeed = config.firstSeed;
+    tournament.maxStepsPerBoard = config.maxStepsPerBoard;
+    tournament.threads = threads;
+    tournament.stepBudget = stepBudget;
+
+    const std::vector<Sim::TournamentResult> results = Sim::runTournament(tournament);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for (const Sim::TournamentResult& result : results) {
+        printStats(result.stats, boardDims(config.width, config.height, config.mineNum), seconds);
+    }
+
+    return 0;
+}
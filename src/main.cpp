@@ -3,42 +3,40 @@
 #include <armadillo>
 
 #include <dansweeperml/core/render.h>
+#include <dansweeperml/core/highlight.h>
 #include <dansweeperml/core/controller.h>
+#include <dansweeperml/core/snapshot.h>
 #include <thread>
 #include <memory>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
 
 #include <dansweeperml/solver/isolver.h>
+#include <dansweeperml/solver/solverstats.h>
+#include <dansweeperml/solver/pacer.h>
+#include <dansweeperml/sim/pregenerator.h>
 #include <dansweeperml/solver/algorithm/bfsoptimized.h>
 #include <dansweeperml/solver/algorithm/linearscan.h>
+#include <dansweeperml/solver/algorithm/frontier.h>
+#include <dansweeperml/solver/algorithm/pattern.h>
+#include <dansweeperml/solver/algorithm/probability.h>
+#include <dansweeperml/solver/algorithm/sampling.h>
 
 #include <dansweeperml/solver/ml/linearregression/linearregressiontrainer.h>
 
-struct SolverStats {
-    std::string name;
-    int steps = 0;
-    int totalSteps = 0;
-    float time = 0.0f;
-    float totalTime = 0.0f;
-    int boardsRun = 1;
-    int win = 0;
-    int lose = 0;
-    float winrate = 0.0f;
-    float averageSteps = 0.0f;
-    float averageTime = 0.0f;
-};
-
 static int iterateRuntype;
 
 std::vector<std::unique_ptr<ISolver>> solvers;
 static int algorithmSelectionIndex = 2;
 
-std::atomic<bool> stepRequested = false;
-std::atomic<bool> gResetReq{false};
-std::atomic<bool> gResetDone{false};
-std::mutex gResetMtx;
-std::condition_variable gResetCv;
 
 static SolverStats stats;
+static SolverPacer pacer;
+
+// flat boards are only touched by the solver thread, everyone else reads what it publishes
+static Grid::SnapshotPublisher snapshots;
+std::atomic<bool> regenerateRequested{false};
 
 void solverstats(const Font &font) {
     std::vector<std::string> listOfText;
@@ -62,6 +60,26 @@ void controls(const Font &font) {
 
     std::vector<std::string> listOfText;
 
+    switch (pacer.getMode()) {
+        case PACE_UNTHROTTLED:
+            listOfText.push_back(std::format("pacing: unthrottled{}", pacer.isPaused() ? ", paused" : ""));
+            break;
+        case PACE_RATE:
+            listOfText.push_back(std::format("pacing: {} steps/s{}", pacer.getStepsPerSecond(), pacer.isPaused() ? ", paused" : ""));
+            break;
+        case PACE_FRAME_LOCKED:
+            listOfText.push_back(std::format("pacing: {} steps/frame{}", pacer.getStepsPerFrame(), pacer.isPaused() ? ", paused" : ""));
+            break;
+    }
+    if (pacer.isBudgeted()) {
+        listOfText.push_back(std::format("step budget: {} us", pacer.getStepBudget().count()));
+    } else {
+        listOfText.push_back(std::format("step budget: off"));
+    }
+    listOfText.push_back(std::format("[b]: toggle step budget"));
+    listOfText.push_back(std::format("[up] [down]: faster, slower"));
+    listOfText.push_back(std::format("[m]: cycle pacing mode"));
+    listOfText.push_back(std::format("[p]: pause solver"));
     listOfText.push_back(std::format("[->]: step forward once"));
     listOfText.push_back(std::format("[h]: toggle highlight"));
     listOfText.push_back(std::format("[a] [d]: cycle main solver type"));
@@ -73,25 +91,41 @@ void controls(const Font &font) {
     }
 }
 
-void debug(const Font &font, Grid::Grid* grid) {
+// chunked boards build chunks on the solver thread, read them under the grid lock
+// flat boards are read from the latest snapshot
+template<class Board>
+void debug(const Font &font, Board* grid) {
+
+    // metadata is borrowed from whichever of the two is held for the whole call, nothing is copied per frame
+    std::shared_lock<std::shared_mutex> rlk;
+    std::shared_ptr<const Grid::BoardSnapshot> snapshot;
+    if constexpr (std::is_same_v<Board, Grid::ChunkedGrid>) {
+        rlk = std::shared_lock(gGridMtx);
+    } else {
+        snapshot = snapshots.acquire();
+    }
+    const Grid::GridMetadata& metadata = snapshot ? snapshot->metadata : grid->getMetadata();
 
     std::vector<std::string> listOfText;
-    Grid::GridMetadata metadata = grid->getMetadata();
-    std::vector<std::vector<Grid::Cell>> cells = grid->getCells();
     auto [cx, cy] = Controller::getCoordinates();
 
     listOfText.push_back(std::format("created by daniel pan"));
     listOfText.push_back(std::format("fps: {}", GetFPS()));
     listOfText.push_back(std::format("dims: {}x{}", metadata.width, metadata.height));
-    listOfText.push_back(std::format("mines: {}, density: {}", metadata.mineNum, static_cast<float>(metadata.mineNum) / (metadata.width * metadata.height)));
+    if constexpr (std::is_same_v<Board, Grid::ChunkedGrid>) {
+        listOfText.push_back(std::format("unbounded, density: {}, chunks: {}", grid->getMineDensity(), grid->getChunkCount()));
+    } else {
+        listOfText.push_back(std::format("mines: {}, density: {}", metadata.mineNum, static_cast<float>(metadata.mineNum) / (metadata.width * metadata.height)));
+    }
     listOfText.push_back(std::format("prng: {}", metadata.prng));
     listOfText.push_back(std::format("safe: {}, {}", metadata.safeX, metadata.safeY));
     listOfText.push_back(std::format("time: {}", metadata.time));
 
     if (cx >= 0 && cy >= 0 && cx < metadata.width && cy < metadata.height) {
         listOfText.push_back(std::format("coords: {}, {}", cx, cy));
-        listOfText.push_back(std::format("mine: {}", cells[cy][cx].content == Grid::CELL_MINE));
-        listOfText.push_back(std::format("adjc: {}", cells[cy][cx].adjacentMines));
+        const Grid::PackedCell cell = snapshot ? snapshot->getPacked(cx, cy) : grid->getPacked(cx, cy);
+        listOfText.push_back(std::format("mine: {}", (cell & Grid::CellBits::MINE) != 0));
+        listOfText.push_back(std::format("adjc: {}", cell & Grid::CellBits::ADJACENT_MASK));
     }
 
     for (int i = 0; i < listOfText.size(); i++) {
@@ -100,9 +134,20 @@ void debug(const Font &font, Grid::Grid* grid) {
 
 }
 
-std::jthread solverThread(Grid::Grid* grid, int& selectionIndex, bool& autoRunSolver) {
+// next board in place, flat boards take a pregenerated one when it is ready
+template<class Board>
+void nextBoard(Board* grid, Sim::BoardPregenerator* pregenerator) {
+    std::unique_lock wlk(gGridMtx);
+    if constexpr (std::is_same_v<Board, Grid::Grid>) {
+        if (pregenerator && pregenerator->swapNext(*grid)) {
+            return;
+        }
+    }
+    grid->generateGrid(grid->getWidth() / 2, grid->getHeight() / 2);
+}
 
-    using namespace std::chrono_literals;
+template<class Board>
+std::jthread solverThread(Board* grid, Sim::BoardPregenerator* pregenerator, int& selectionIndex) {
 
     auto resetSolverStats = [](SolverStats s) {
         s.steps = 0;
@@ -117,41 +162,33 @@ std::jthread solverThread(Grid::Grid* grid, int& selectionIndex, bool& autoRunSo
         s.totalTime = 0;
     };
 
-    return std::jthread([grid, &selectionIndex, &autoRunSolver, resetSolverStats](std::stop_token st) {
+    return std::jthread([grid, pregenerator, &selectionIndex, resetSolverStats](std::stop_token st) {
 
         // register algorithmic solvers
         solvers.push_back(std::make_unique<algorithmlinearscan::LinearScan>());
         solvers.push_back(std::make_unique<algorithmbfsoptimized::BFSUnoptimized>());
         solvers.push_back(std::make_unique<mllinearregressiontrainer::LinearRegressionTrainer>(5000, "models/lr.bin"));
+        solvers.push_back(std::make_unique<algorithmpattern::PatternSolver>());
+        solvers.push_back(std::make_unique<algorithmfrontier::FrontierSolver>());
+        solvers.push_back(std::make_unique<algorithmprobability::ProbabilitySolver>(std::thread::hardware_concurrency()));
+        solvers.push_back(std::make_unique<algorithmsampling::SamplingSolver>(std::thread::hardware_concurrency()));
 
         size_t current = solvers.empty() ? 0 : (selectionIndex % solvers.size());
         ISolver* solver = solvers[current].get();
+        Grid::ActionBatch actions;
 
         auto resetRun = [&] {
 
-            const auto meta = grid->getMetadata();
+            const Grid::GridMetadata& meta = grid->getMetadata();
 
             stats.time = meta.time;
             stats.totalTime += meta.time;
             stats.totalSteps += solver->getSteps();
 
 
-            // request generate grid
-            gResetReq.store(true, std::memory_order_release);
-            {
-                std::unique_lock lk(gResetMtx);
-                gResetCv.wait_for(lk, std::chrono::milliseconds(100), [&] {
-                    return gResetDone.load(std::memory_order_acquire) || st.stop_requested();
-                });
-            }
-
-            if (st.stop_requested()) {
-                return;
-            }
+            nextBoard(grid, pregenerator);
 
-            gResetDone.store(false, std::memory_order_release);
-
-            Render::resetHighlightTiles();
+            Highlight::resetHighlightTiles();
             solver = solvers[current].get();
             solver->reset();
 
@@ -175,14 +212,42 @@ std::jthread solverThread(Grid::Grid* grid, int& selectionIndex, bool& autoRunSo
                 solver->reset();
             }
 
-            if (autoRunSolver || stepRequested.exchange(false)) {
+            // blocks while paused or until the pacing mode lets the next step through
+            if (pacer.waitForStep(st)) {
                 stats.steps++;
-                if (!solver->step(*grid)) {
+
+                // follows the pacing mode, a budgeted step never holds up a pause, a solver switch or a chunked frame for long
+                solver->setStepBudget(pacer.getStepBudget());
+
+                // chunk maps grow during a step, the renderer must not walk them meanwhile
+                std::unique_lock<std::shared_mutex> stepLock;
+                if constexpr (std::is_same_v<Board, Grid::ChunkedGrid>) {
+                    stepLock = std::unique_lock(gGridMtx);
+                }
+
+                bool stepped;
+                if constexpr (std::is_same_v<Board, Grid::Grid>) {
+                    actions.clear();
+                    stepped = solver->stepActions(*grid, actions);
+                    grid->apply(actions);
+                } else {
+                    stepped = solver->step(*grid);
+                }
+                if (stepLock.owns_lock()) {
+                    stepLock.unlock();
+                }
+
+                if (!stepped) {
                     resetRun();
                 }
             }
 
-            auto currentGridState = grid->getMetadata().gridState;
+            if (regenerateRequested.exchange(false)) {
+                nextBoard(grid, pregenerator);
+                solver->reset();
+            }
+
+            auto currentGridState = grid->getGridState();
             if (currentGridState == Grid::FINISHED_LOSE || currentGridState == Grid::FINISHED_WIN) {
 
                 switch (currentGridState) {
@@ -199,7 +264,14 @@ std::jthread solverThread(Grid::Grid* grid, int& selectionIndex, bool& autoRunSo
 
             }
 
-            std::this_thread::sleep_for(100ms);
+            // the timer and the snapshots move with the solver, the render thread never writes the board
+            if constexpr (std::is_same_v<Board, Grid::Grid>) {
+                grid->updateTimer();
+                snapshots.publish(*grid);
+            } else {
+                std::unique_lock wlk(gGridMtx);
+                grid->updateTimer();
+            }
 
         }
 
@@ -208,19 +280,25 @@ std::jthread solverThread(Grid::Grid* grid, int& selectionIndex, bool& autoRunSo
 }
 
 
-int main() {
+template<class Board>
+int runWindow(Board* currentGrid) {
 
     const int screenWidth = 800;
     const int screenHeight = 600;
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     SetConfigFlags(FLAG_VSYNC_HINT);
     SetTargetFPS(240);
-    Grid::Grid* currentGrid = new Grid::Grid(9, 9, 10);
+    currentGrid->setClock(GetTime);
 
     InitWindow(screenWidth, screenHeight, "dansweeperml");
 
     Camera2D camera;
-    Render::initializeRender(camera, currentGrid);
+    if constexpr (std::is_same_v<Board, Grid::Grid>) {
+        snapshots.publish(*currentGrid);
+        Render::initializeRender(camera, &snapshots);
+    } else {
+        Render::initializeRender(camera, currentGrid);
+    }
     Controller::initializeController(camera, currentGrid);
 
     Render::loadTexture();
@@ -228,11 +306,17 @@ int main() {
     SetTextureFilter(customFont.texture, TEXTURE_FILTER_POINT);
 
     bool drawHighlight = false;
-    bool autoRunSolver = true;
 
     currentGrid->generateGrid(4, 4);
 
-    std::jthread walker = solverThread(currentGrid, algorithmSelectionIndex, autoRunSolver);
+    // chunked boards are built lazily, only flat boards are worth generating ahead
+    std::unique_ptr<Sim::BoardPregenerator> pregenerator;
+    if constexpr (std::is_same_v<Board, Grid::Grid>) {
+        const Grid::GridMetadata& meta = currentGrid->getMetadata();
+        pregenerator = std::make_unique<Sim::BoardPregenerator>(meta.height, meta.width, meta.mineNum, meta.width / 2, meta.height / 2);
+    }
+
+    std::jthread walker = solverThread(currentGrid, pregenerator.get(), algorithmSelectionIndex);
 
     while (!WindowShouldClose()) {
 
@@ -240,38 +324,46 @@ int main() {
         Controller::cameraPan();
         Controller::cameraHover();
 
-        // regenerate grid request
-        if (gResetReq.exchange(false, std::memory_order_acq_rel)) {
-            {
-                std::unique_lock wlk(gGridMtx);
-                currentGrid->generateGrid(currentGrid->getMetadata().width / 2, currentGrid->getMetadata().height / 2);
-            }
-            {
-                std::lock_guard lk(gResetMtx);
-                gResetDone.store(true, std::memory_order_release);
-            }
-            gResetCv.notify_all();
-        }
-
         // debug new board
         if (IsKeyDown(KEY_SPACE)) {
-            currentGrid->generateGrid(currentGrid->getMetadata().width / 2, currentGrid->getMetadata().height / 2);
+            regenerateRequested.store(true);
+            pacer.wake();
         }
 
+        // a paused solver thread only sees the new selection once woken
         if (IsKeyPressed(KEY_W)) {
             algorithmSelectionIndex = (algorithmSelectionIndex + 1) % solvers.size();
+            pacer.wake();
         }
 
         if (IsKeyPressed(KEY_S)) {
             algorithmSelectionIndex = (algorithmSelectionIndex + solvers.size() - 1) % solvers.size();
+            pacer.wake();
         }
 
         if (IsKeyPressed(KEY_P)) {
-            autoRunSolver = !autoRunSolver;
+            pacer.setPaused(!pacer.isPaused());
+        }
+
+        if (IsKeyPressed(KEY_M)) {
+            pacer.setMode(static_cast<PacingMode>((pacer.getMode() + 1) % (PACE_FRAME_LOCKED + 1)));
+        }
+
+        if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_DOWN)) {
+            const bool faster = IsKeyPressed(KEY_UP);
+            if (pacer.getMode() == PACE_RATE) {
+                pacer.setStepsPerSecond(pacer.getStepsPerSecond() * (faster ? 2.0 : 0.5));
+            } else if (pacer.getMode() == PACE_FRAME_LOCKED) {
+                pacer.setStepsPerFrame(faster ? pacer.getStepsPerFrame() * 2 : pacer.getStepsPerFrame() / 2);
+            }
         }
 
         if (IsKeyPressed(KEY_RIGHT)) {
-            stepRequested.store(true, std::memory_order_relaxed);
+            pacer.requestStep();
+        }
+
+        if (IsKeyPressed(KEY_B)) {
+            pacer.setBudgeted(!pacer.isBudgeted());
         }
 
         if (IsKeyPressed(KEY_H)) {
@@ -282,13 +374,12 @@ int main() {
 
         ClearBackground(BLACK);
         Render::renderThread(drawHighlight);
-        currentGrid->updateTimer();
-
         debug(customFont, currentGrid);
         controls(customFont);
         solverstats(customFont);
 
         EndDrawing();
+        pacer.frameRendered();
 
     }
 
@@ -301,3 +392,14 @@ int main() {
     CloseWindow();
     return 0;
 }
+
+// dansweeper_ml [--unbounded density]
+// --unbounded plays a chunked board that is built as the solver explores it
+int main(int argc, char** argv) {
+
+    if (argc > 2 && std::string(argv[1]) == "--unbounded") {
+        return runWindow(new Grid::ChunkedGrid(std::strtof(argv[2], nullptr)));
+    }
+
+    return runWindow(new Grid::Grid(9, 9, 10));
+}
@@ -0,0 +1,125 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/sim/batchrunner.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace Sim {
+
+    template<class Board>
+    static Grid::GridState runBoardOn(ISolver& solver, Board& grid, int maxSteps, int& steps) {
+
+        solver.reset();
+        steps = 0;
+
+        // flat boards take each step as one batch, chunked boards are still stepped directly
+        Grid::ActionBatch actions;
+        while (grid.getGridState() == Grid::ONGOING && steps < maxSteps) {
+            steps++;
+            bool stepped;
+            if constexpr (std::is_same_v<Board, Grid::Grid>) {
+                actions.clear();
+                stepped = solver.stepActions(grid, actions);
+                grid.apply(actions);
+            } else {
+                stepped = solver.step(grid);
+            }
+            if (!stepped) {
+                break;
+            }
+        }
+
+        grid.updateTimer();
+        return grid.getGridState();
+    }
+
+    Grid::GridState runBoard(ISolver& solver, Grid::Grid& grid, int maxSteps, int& steps) {
+        return runBoardOn(solver, grid, maxSteps, steps);
+    }
+
+    Grid::GridState runBoard(ISolver& solver, Grid::ChunkedGrid& grid, int maxSteps, int& steps) {
+        return runBoardOn(solver, grid, maxSteps, steps);
+    }
+
+    SolverStats runBatch(ISolver& solver, const BatchConfig& config) {
+
+        SolverStats stats;
+        stats.name = solver.getName();
+        stats.boardsRun = 0;
+
+        Grid::Grid grid(config.height, config.width, config.mineNum);
+        if (config.clock) {
+            grid.setClock(config.clock);
+        }
+
+        for (int board = 0; board < config.boards; board++) {
+            grid.generateGrid(config.width / 2, config.height / 2, config.firstSeed + board);
+
+            int steps = 0;
+            const Grid::GridState result = runBoard(solver, grid, config.maxStepsPerBoard, steps);
+            recordBoard(stats, steps, grid.getMetadata().time, result);
+        }
+
+        return stats;
+    }
+
+    SolverStats runCorpus(ISolver& solver, const Corpus::CorpusReader& corpus, int maxStepsPerBoard) {
+
+        SolverStats stats;
+        stats.name = solver.getName();
+        stats.boardsRun = 0;
+
+        Grid::Grid grid(1, 1, 0);
+        for (std::uint64_t board = 0; board < corpus.size(); board++) {
+            corpus.load(board, grid);
+
+            int steps = 0;
+            const Grid::GridState result = runBoard(solver, grid, maxStepsPerBoard, steps);
+            recordBoard(stats, steps, grid.getMetadata().time, result);
+        }
+
+        return stats;
+    }
+
+    UnboundedStats runUnbounded(ISolver& solver, float mineDensity, const BatchConfig& config) {
+
+        UnboundedStats stats;
+        stats.name = solver.getName();
+
+        Grid::ChunkedGrid grid(mineDensity);
+        if (config.clock) {
+            grid.setClock(config.clock);
+        }
+
+        double totalSteps = 0.0;
+        double totalRevealed = 0.0;
+        double totalChunks = 0.0;
+
+        for (int board = 0; board < config.boards; board++) {
+            grid.generateGrid(Grid::ChunkedGrid::EXTENT / 2, Grid::ChunkedGrid::EXTENT / 2, config.firstSeed + board);
+
+            int steps = 0;
+            if (runBoard(solver, grid, config.maxStepsPerBoard, steps) == Grid::FINISHED_LOSE) {
+                stats.lose++;
+            }
+
+            stats.boardsRun++;
+            totalSteps += steps;
+            totalRevealed += static_cast<double>(grid.getRevealedCount());
+            totalChunks += static_cast<double>(grid.getChunkCount());
+            stats.peakBytes = std::max(stats.peakBytes, grid.getMemoryBytes());
+        }
+
+        if (stats.boardsRun > 0) {
+            stats.averageSteps = totalSteps / stats.boardsRun;
+            stats.averageRevealed = totalRevealed / stats.boardsRun;
+            stats.averageChunks = totalChunks / stats.boardsRun;
+        }
+
+        return stats;
+    }
+
+} // Sim
@@ -0,0 +1,73 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/sim/pregenerator.h>
+
+#include <algorithm>
+
+namespace Sim {
+
+    BoardPregenerator::BoardPregenerator(int height, int width, int mineNum, int safeX, int safeY, int depth)
+        : safeX(safeX), safeY(safeY) {
+
+        for (int i = 0; i < std::max(depth, 1); i++) {
+            spare.push_back(std::make_unique<Grid::Grid>(height, width, mineNum));
+        }
+        worker = std::thread([this] { run(); });
+    }
+
+    BoardPregenerator::~BoardPregenerator() {
+        {
+            std::lock_guard lk(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    bool BoardPregenerator::swapNext(Grid::Grid& grid) {
+        std::unique_ptr<Grid::Grid> next;
+        {
+            std::lock_guard lk(mtx);
+            if (ready.empty()) {
+                return false;
+            }
+            next = std::move(ready.front());
+            ready.erase(ready.begin());
+        }
+
+        grid.swapBoard(*next);
+
+        {
+            std::lock_guard lk(mtx);
+            spare.push_back(std::move(next));
+        }
+        cv.notify_one();
+        return true;
+    }
+
+    // generation runs outside the lock, only handing boards over takes it
+    void BoardPregenerator::run() {
+        while (true) {
+            std::unique_ptr<Grid::Grid> board;
+            {
+                std::unique_lock lk(mtx);
+                cv.wait(lk, [this] { return stopping || !spare.empty(); });
+                if (stopping) {
+                    return;
+                }
+                board = std::move(spare.back());
+                spare.pop_back();
+            }
+
+            board->generateGrid(safeX, safeY);
+
+            {
+                std::lock_guard lk(mtx);
+                ready.push_back(std::move(board));
+            }
+        }
+    }
+
+} // Sim
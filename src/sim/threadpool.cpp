@@ -0,0 +1,142 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/sim/threadpool.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace Sim {
+
+    static thread_local int currentWorker = -1;
+    static thread_local ThreadPool* currentPool = nullptr;
+
+    ThreadPool::ThreadPool(unsigned threads) {
+        threads = std::max(threads, 1u);
+
+        for (unsigned i = 0; i < threads; i++) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned i = 0; i < threads; i++) {
+            workers.emplace_back([this, i] { workerLoop(static_cast<int>(i)); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lk(sleepMtx);
+            stopping = true;
+        }
+        sleepCv.notify_all();
+        workers.clear();
+    }
+
+    int ThreadPool::getWorkerIndex() {
+        return currentWorker;
+    }
+
+    void ThreadPool::submit(std::function<void()> task) {
+
+        const size_t target = (currentPool == this) ? currentWorker : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        // counted under the queue lock so a thief can never take the task before it is counted
+        {
+            std::lock_guard lk(queues[target]->mtx);
+            queues[target]->tasks.push_back(std::move(task));
+            pending.fetch_add(1, std::memory_order_release);
+        }
+
+        // empty critical section orders the wakeup after a worker that saw no pending work has parked
+        {
+            std::lock_guard lk(sleepMtx);
+        }
+        sleepCv.notify_one();
+    }
+
+    bool ThreadPool::tryPop(int self, std::function<void()>& task) {
+
+        // own deque newest first, keeps nested work hot in cache
+        if (self >= 0) {
+            Queue& own = *queues[self];
+            std::lock_guard lk(own.mtx);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // steal oldest from the others, oldest tasks tend to be the largest
+        const int count = static_cast<int>(queues.size());
+        const int start = std::max(self, 0);
+        for (int offset = 1; offset <= count; offset++) {
+            Queue& victim = *queues[(start + offset) % count];
+            std::lock_guard lk(victim.mtx);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool ThreadPool::runPendingTask() {
+        std::function<void()> task;
+        if (!tryPop(currentPool == this ? currentWorker : -1, task)) {
+            return false;
+        }
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        task();
+        return true;
+    }
+
+    void ThreadPool::workerLoop(int self) {
+
+        currentWorker = self;
+        currentPool = this;
+
+        while (true) {
+            if (runPendingTask()) {
+                continue;
+            }
+
+            std::unique_lock lk(sleepMtx);
+            sleepCv.wait(lk, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+            if (stopping && pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    void TaskGroup::run(std::function<void()> task) {
+        remaining.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([this, task = std::move(task)] {
+            task();
+            std::lock_guard lk(doneMtx);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                doneCv.notify_all();
+            }
+        });
+    }
+
+    void TaskGroup::wait() {
+
+        using namespace std::chrono_literals;
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (pool.runPendingTask()) {
+                continue;
+            }
+
+            // everything left is running elsewhere, wake up now and then in case it spawns more
+            std::unique_lock lk(doneMtx);
+            doneCv.wait_for(lk, 200us, [this] { return remaining.load(std::memory_order_acquire) == 0; });
+        }
+
+        // the last task still holds doneMtx while it notifies, the group must outlive that
+        std::lock_guard lk(doneMtx);
+    }
+
+} // Sim
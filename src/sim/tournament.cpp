@@ -0,0 +1,123 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/sim/tournament.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include <dansweeperml/core/grid.h>
+#include <dansweeperml/sim/batchrunner.h>
+#include <dansweeperml/sim/threadpool.h>
+#include <dansweeperml/solver/registry.h>
+
+namespace Sim {
+
+    namespace {
+
+        // everything a worker touches while playing, never shared between workers
+        struct WorkerState {
+            std::vector<std::unique_ptr<ISolver>> solvers;
+            std::vector<std::unique_ptr<Grid::Grid>> grids;
+            std::vector<SolverStats> stats;
+        };
+
+    }
+
+    std::vector<TournamentResult> runTournament(const TournamentConfig& config) {
+
+        ThreadPool pool(config.threads > 0 ? config.threads : std::thread::hardware_concurrency());
+
+        // this thread plays too while it waits
+        const unsigned players = pool.getThreadCount() + 1;
+        const unsigned solverThreads = config.solverThreads > 0
+                                       ? config.solverThreads
+                                       : std::max(std::thread::hardware_concurrency() / players, 1u);
+
+        std::vector<std::string> keys;
+        std::vector<std::string> names;
+        for (const std::string& key : config.solverKeys) {
+            if (const std::unique_ptr<ISolver> solver = SolverRegistry::makeSolver(key, solverThreads)) {
+                keys.push_back(key);
+                names.push_back(solver->getName());
+            }
+        }
+
+        const int configCount = static_cast<int>(config.boardConfigs.size());
+        const int pairCount = static_cast<int>(keys.size()) * configCount;
+
+        // the last slot belongs to this thread, which runs tasks too while it waits
+        std::vector<WorkerState> workerStates(pool.getThreadCount() + 1);
+        for (WorkerState& state : workerStates) {
+            state.solvers.resize(keys.size());
+            state.grids.resize(configCount);
+            state.stats.resize(pairCount);
+            for (SolverStats& stats : state.stats) {
+                stats.boardsRun = 0;
+            }
+        }
+
+        {
+            TaskGroup group(pool);
+            const int chunk = std::max(config.boardsPerTask, 1);
+
+            for (int solverIndex = 0; solverIndex < static_cast<int>(keys.size()); solverIndex++) {
+                for (int configIndex = 0; configIndex < configCount; configIndex++) {
+                    for (int first = 0; first < config.boardsPerConfig; first += chunk) {
+
+                        const int count = std::min(chunk, config.boardsPerConfig - first);
+                        group.run([&, solverIndex, configIndex, first, count] {
+
+                            const int worker = ThreadPool::getWorkerIndex();
+                            WorkerState& state = workerStates[worker >= 0 ? worker : pool.getThreadCount()];
+                            const BoardConfig& board = config.boardConfigs[configIndex];
+
+                            std::unique_ptr<ISolver>& solver = state.solvers[solverIndex];
+                            if (!solver) {
+                                solver = SolverRegistry::makeSolver(keys[solverIndex], solverThreads);
+                                solver->setStepBudget(config.stepBudget);
+                            }
+
+                            std::unique_ptr<Grid::Grid>& grid = state.grids[configIndex];
+                            if (!grid) {
+                                grid = std::make_unique<Grid::Grid>(board.height, board.width, board.mineNum);
+                            }
+
+                            SolverStats& stats = state.stats[solverIndex * configCount + configIndex];
+                            for (int i = 0; i < count; i++) {
+                                grid->generateGrid(board.width / 2, board.height / 2, config.firstSeed + first + i);
+
+                                int steps = 0;
+                                const Grid::GridState result = runBoard(*solver, *grid, config.maxStepsPerBoard, steps);
+                                recordBoard(stats, steps, grid->getMetadata().time, result);
+                            }
+                        });
+                    }
+                }
+            }
+
+            group.wait();
+        }
+
+        // workers are done, fold their private totals
+        std::vector<TournamentResult> results;
+        for (int solverIndex = 0; solverIndex < static_cast<int>(keys.size()); solverIndex++) {
+            for (int configIndex = 0; configIndex < configCount; configIndex++) {
+
+                TournamentResult result{keys[solverIndex], config.boardConfigs[configIndex], {}};
+                result.stats.name = names[solverIndex];
+                result.stats.boardsRun = 0;
+
+                for (const WorkerState& state : workerStates) {
+                    mergeStats(result.stats, state.stats[solverIndex * configCount + configIndex]);
+                }
+                results.push_back(std::move(result));
+            }
+        }
+
+        return results;
+    }
+
+} // Sim
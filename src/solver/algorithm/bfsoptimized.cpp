@@ -3,7 +3,7 @@
 //
 
 #include <dansweeperml/solver/algorithm/bfsoptimized.h>
-#include <dansweeperml/core/render.h>
+#include <dansweeperml/core/highlight.h>
 #include <dansweeperml/core/grid.h>
 #include <iostream>
 #include <random>
@@ -11,14 +11,116 @@
 
 namespace algorithmbfsoptimized {
 
+    namespace {
+
+        // records moves as flat indices instead of playing them, so the step reads the board as it began
+        class BatchMoves {
+        public:
+            BatchMoves(const Grid::Grid& grid, Grid::ActionBatch& actions) : grid(grid), actions(actions) {}
+
+            void reveal(int x, int y) { record(actions.reveals, x, y); }
+            void chord(int x, int y) { record(actions.chords, x, y); }
+            void flag(int x, int y) { record(actions.flags, x, y); }
+
+            // stands in for the grid's count, a move recorded is a move made
+            std::uint64_t getMutationCount() const {
+                return actions.reveals.size() + actions.chords.size() + actions.flags.size();
+            }
+
+        private:
+            const Grid::Grid& grid;
+            Grid::ActionBatch& actions;
+
+            void record(std::vector<int>& into, int x, int y) {
+                if (x >= 0 && x < grid.getWidth() && y >= 0 && y < grid.getHeight()) {
+                    into.push_back(grid.index(x, y));
+                }
+            }
+        };
+
+    }
+
     bool BFSUnoptimized::step(Grid::Grid& grid) {
-        auto meta = grid.getMetadata();
-        const auto cells = grid.getCells();
+        batch.clear();
+        const bool moved = stepActions(grid, batch);
+        grid.apply(batch);
+        return moved;
+    }
+
+    bool BFSUnoptimized::step(Grid::ChunkedGrid& grid) {
+        return stepOn(grid, grid);
+    }
+
+    bool BFSUnoptimized::stepActions(Grid::Grid& grid, Grid::ActionBatch& actions) {
+        BatchMoves moves(grid, actions);
+        return stepOn(grid, moves);
+    }
+
+    // only cells revealed since the last step are new, full scan once per board
+    void BFSUnoptimized::collectNumberTiles(Grid::Grid& grid) {
+        const int width = grid.getWidth();
+        const int height = grid.getHeight();
+
+        std::span<const Grid::CellDelta> changes;
+        if (grid.readJournal(journalCursor, changes)) {
+
+            for (const Grid::CellDelta& change : changes) {
+                const bool newlyRevealed = !(change.before & Grid::CellBits::REVEALED) && (change.after & Grid::CellBits::REVEALED);
+                if (newlyRevealed && (change.after & Grid::CellBits::ADJACENT_MASK) > 0) {
+                    revealedNumberTiles.insert({static_cast<int>(change.index % width), static_cast<int>(change.index / width)});
+                }
+            }
+
+        } else {
+
+            for (int i = 0; i < height; i++) {
+
+                for (int j = 0; j < width; j++) {
+
+                    if (grid.isRevealed(j, i) && grid.getAdjacentMines(j, i) > 0) {
+                        revealedNumberTiles.insert({j, i});
+                    }
+                }
+            }
+        }
+    }
+
+    // the full scan only visits chunks that were built, the rest of the board is untouched
+    void BFSUnoptimized::collectNumberTiles(Grid::ChunkedGrid& grid) {
+
+        std::span<const Grid::PointDelta> changes;
+        if (grid.readJournal(journalCursor, changes)) {
+
+            for (const Grid::PointDelta& change : changes) {
+                const bool newlyRevealed = !(change.before & Grid::CellBits::REVEALED) && (change.after & Grid::CellBits::REVEALED);
+                if (newlyRevealed && (change.after & Grid::CellBits::ADJACENT_MASK) > 0) {
+                    revealedNumberTiles.insert({change.x, change.y});
+                }
+            }
+
+        } else {
+
+            grid.forEachChunk([this](int chunkX, int chunkY, const Grid::PackedCell* cells) {
+                for (int i = 0; i < Grid::ChunkedGrid::CHUNK_CELLS; i++) {
+                    if ((cells[i] & Grid::CellBits::REVEALED) && (cells[i] & Grid::CellBits::ADJACENT_MASK) > 0) {
+                        revealedNumberTiles.insert({chunkX * Grid::ChunkedGrid::CHUNK_SIZE + i % Grid::ChunkedGrid::CHUNK_SIZE,
+                                                    chunkY * Grid::ChunkedGrid::CHUNK_SIZE + i / Grid::ChunkedGrid::CHUNK_SIZE});
+                    }
+                }
+            });
+        }
+    }
+
+    template<class Board, class Moves>
+    bool BFSUnoptimized::stepOn(Board& grid, Moves& moves) {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        const std::uint64_t mutationsBefore = moves.getMutationCount();
 
         if (!started) {
             started = true;
-            grid.reveal(meta.width / 2, meta.height / 2);
-            Render::queueHighlightTile(meta.width / 2, meta.height / 2);
+            moves.reveal(meta.width / 2, meta.height / 2);
+            Highlight::queueHighlightTile(meta.width / 2, meta.height / 2);
+            return true;
 
         } else {
 
@@ -28,16 +130,7 @@ namespace algorithmbfsoptimized {
             float heuristicRatio = 1.0f;
             std::pair<int, int> heuristicPair = {-1, -1};
             // get all revealed NUMBER tiles i.e. "nodes"
-            for (int i = 0; i < meta.height; i++) {
-
-                for (int j = 0; j < meta.width; j++) {
-
-                    Grid::Cell firstPass = grid.getCellProperties(j, i);
-                    if (firstPass.revealed && firstPass.adjacentMines > 0 && revealedNumberTiles.find({j, i}) == revealedNumberTiles.end()) {
-                        revealedNumberTiles.insert({j, i});
-                    }
-                }
-            }
+            collectNumberTiles(grid);
 
             for (std::pair<int, int> revealedNumberTile : revealedNumberTiles) {
 
@@ -47,7 +140,7 @@ namespace algorithmbfsoptimized {
 
                 auto [x, y] = revealedNumberTile;
 
-                Render::queueHighlightTile(x, y);
+                Highlight::queueHighlightTile(x, y);
                 std::vector<std::pair<int, int>> neighbors = getNeighbors(x, y, meta.width, meta.height);
                 Grid::Cell cellRevealedProperties = grid.getCellProperties(x, y);
 
@@ -84,7 +177,7 @@ namespace algorithmbfsoptimized {
 
                     // unnecessary chord again if all thats around is flagged == unrevealed
                     if (unrevealedNeighbors != flaggedNeighbors) {
-                        grid.chord(x, y);
+                        moves.chord(x, y);
                         chordOrFlagged = true;
                     }
 
@@ -103,7 +196,7 @@ namespace algorithmbfsoptimized {
                         Grid::Cell cellNeighborProperties = grid.getCellProperties(flagX, flagY);
                         if (cellNeighborProperties.flagged == false && cellNeighborProperties.revealed == false) {
 
-                            grid.flag(flagX, flagY);
+                            moves.flag(flagX, flagY);
 
                             chordOrFlagged = true;
                         }
@@ -118,7 +211,6 @@ namespace algorithmbfsoptimized {
                     if (possibleMine > 0 && unrevealedNeighbors > 0 && possibleMine / unrevealedNeighbors < heuristicRatio) {
 
                         heuristicRatio = possibleMine / unrevealedNeighbors;
-                        static std::mt19937 rng(static_cast<unsigned int>(std::time(nullptr)));
                         std::uniform_int_distribution<size_t> dist(0, neighbors.size() - 1);
                         // randomly choose so terribly
 
@@ -142,12 +234,13 @@ namespace algorithmbfsoptimized {
             if (!chordOrFlagged) {
 
                 auto [x, y] = heuristicPair;
-                grid.reveal(x, y);
-                Render::queueHighlightTile(x, y);
+                moves.reveal(x, y);
+                Highlight::queueHighlightTile(x, y);
 
             }
 
-            if (cells == grid.getCells()) {
+            // nothing was revealed or flagged this step
+            if (moves.getMutationCount() == mutationsBefore) {
                 std::cout << "failed stuck" << std::endl;
                 return false;
             }
@@ -156,7 +249,7 @@ namespace algorithmbfsoptimized {
             return true;
         }
 
-    };
+    }
 
     std::vector<std::pair<int, int>> BFSUnoptimized::getNeighbors(int x, int y, int width, int height) {
         std::vector<std::pair<int, int>> neighbors;
@@ -182,6 +275,7 @@ namespace algorithmbfsoptimized {
         steps = 0;
         visited.clear();
         revealedNumberTiles.clear();
+        journalCursor = {};
         started = false;
     }
 
@@ -0,0 +1,368 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/solver/algorithm/frontier.h>
+#include <dansweeperml/core/highlight.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+
+namespace algorithmfrontier {
+
+    // calls f(neighbour) for every in bounds 8-neighbour of a flat cell
+    template<class F>
+    static void forNeighbors(int cell, int width, int height, F&& f) {
+        const int x = cell % width;
+        const int y = cell / width;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const int nx = x + dx;
+                const int ny = y + dy;
+                if ((dx != 0 || dy != 0) && nx >= 0 && nx < width && ny >= 0 && ny < height) {
+                    f(ny * width + nx);
+                }
+            }
+        }
+    }
+
+    bool FrontierSolver::step(Grid::Grid& grid) {
+        batch.clear();
+        const bool moved = stepActions(grid, batch);
+        grid.apply(batch);
+        return moved;
+    }
+
+    bool FrontierSolver::stepActions(Grid::Grid& grid, Grid::ActionBatch& actions) {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        deadline = StepDeadline(stepBudget);
+
+        if (!started) {
+            started = true;
+            resize(grid);
+            actions.reveals.push_back(grid.index(meta.width / 2, meta.height / 2));
+            Highlight::queueHighlightTile(meta.width / 2, meta.height / 2);
+            steps++;
+            return true;
+        }
+
+        collectChanges(grid);
+        propagate(grid);
+
+        if (safeMoves.empty() && mineMoves.empty()) {
+            steps++;
+            return guess(grid, actions);
+        }
+
+        // deductions become grid state once the batch is applied, the marks are not needed past this step
+        for (int cell : mineMoves) {
+            deduced[cell] = UNKNOWN;
+            actions.flags.push_back(cell);
+            Highlight::queueHighlightTile(cell % width, cell / width);
+        }
+        for (int cell : safeMoves) {
+            deduced[cell] = UNKNOWN;
+            actions.reveals.push_back(cell);
+            Highlight::queueHighlightTile(cell % width, cell / width);
+        }
+        safeMoves.clear();
+        mineMoves.clear();
+
+        steps++;
+        return true;
+    }
+
+    void FrontierSolver::resize(const Grid::Grid& grid) {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        const size_t cells = static_cast<size_t>(meta.width) * meta.height;
+
+        width = meta.width;
+        height = meta.height;
+        frontier.clear();
+        frontierPos.assign(cells, -1);
+        worklist.clear();
+        queued.assign(cells, 0);
+        deduced.assign(cells, UNKNOWN);
+    }
+
+    // numbers next to anything that changed are the only ones whose constraint changed
+    void FrontierSolver::collectChanges(Grid::Grid& grid) {
+
+        std::span<const Grid::CellDelta> changes;
+        if (grid.readJournal(journalCursor, changes)) {
+
+            for (const Grid::CellDelta& change : changes) {
+                const int cell = static_cast<int>(change.index);
+                const Grid::PackedCell toggled = change.before ^ change.after;
+
+                if (toggled & Grid::CellBits::REVEALED) {
+                    enqueue(grid, cell);
+                    enqueueNumberNeighbors(grid, cell);
+                } else if (toggled & Grid::CellBits::FLAGGED) {
+                    enqueueNumberNeighbors(grid, cell);
+                }
+            }
+
+        } else {
+
+            // first step of a board or the journal restarted, every revealed number is a candidate
+            grid.getRevealedPlane().forEachSet([&](int x, int y) {
+                enqueue(grid, grid.index(x, y));
+            });
+        }
+    }
+
+    void FrontierSolver::enqueue(const Grid::Grid& grid, int cell) {
+        const int x = cell % width;
+        const int y = cell / width;
+        if (!queued[cell] && grid.isRevealed(x, y) && grid.getAdjacentMines(x, y) > 0) {
+            queued[cell] = 1;
+            worklist.push_back(cell);
+        }
+    }
+
+    void FrontierSolver::enqueueNumberNeighbors(const Grid::Grid& grid, int cell) {
+        forNeighbors(cell, width, height, [&](int neighbor) {
+            enqueue(grid, neighbor);
+        });
+    }
+
+    FrontierSolver::Constraint FrontierSolver::getConstraint(const Grid::Grid& grid, int cell) const {
+        Constraint constraint;
+        constraint.mines = grid.getAdjacentMines(cell % width, cell / width);
+
+        forNeighbors(cell, width, height, [&](int neighbor) {
+            const int x = neighbor % width;
+            const int y = neighbor / width;
+            if (grid.isFlagged(x, y) || deduced[neighbor] == DEDUCED_MINE) {
+                constraint.mines--;
+            } else if (!grid.isRevealed(x, y) && deduced[neighbor] != DEDUCED_SAFE) {
+                constraint.cells[constraint.count++] = neighbor;
+            }
+        });
+
+        return constraint;
+    }
+
+    void FrontierSolver::propagate(const Grid::Grid& grid) {
+
+        while (!worklist.empty()) {
+            const int cell = worklist.back();
+            worklist.pop_back();
+            queued[cell] = 0;
+
+            const Constraint constraint = getConstraint(grid, cell);
+            setFrontier(cell, constraint.count > 0);
+            if (constraint.count == 0) {
+                continue;
+            }
+
+            // single cell rules
+            if (constraint.mines == 0 || constraint.mines == constraint.count) {
+                for (int i = 0; i < constraint.count; i++) {
+                    if (constraint.mines == 0) {
+                        markSafe(grid, constraint.cells[i]);
+                    } else {
+                        markMine(grid, constraint.cells[i]);
+                    }
+                }
+                continue;
+            }
+
+            // subset rules against frontier numbers that can share an unknown, at most two cells away
+            const int x = cell % width;
+            const int y = cell / width;
+            bool changed = false;
+
+            for (int ny = std::max(y - 2, 0); ny <= std::min(y + 2, height - 1) && !changed; ny++) {
+                for (int nx = std::max(x - 2, 0); nx <= std::min(x + 2, width - 1) && !changed; nx++) {
+                    const int other = ny * width + nx;
+                    if (other == cell || frontierPos[other] < 0) {
+                        continue;
+                    }
+
+                    const Constraint otherConstraint = getConstraint(grid, other);
+                    changed = applyPair(grid, constraint, otherConstraint) || applyPair(grid, otherConstraint, constraint);
+                }
+            }
+
+            // marks only requeue neighbours of the marked cells, this number may have more to give
+            if (changed) {
+                enqueue(grid, cell);
+            }
+        }
+    }
+
+    // b minus a holds b.mines - a.mines mines at least
+    // when that fills every cell only b has, those are mines and every cell only a has is safe
+    // with a inside b and equal counts the cells only b has are safe
+    bool FrontierSolver::applyPair(const Grid::Grid& grid, const Constraint& a, const Constraint& b) {
+
+        int onlyA[8];
+        int onlyB[8];
+        int onlyACount = 0;
+        int onlyBCount = 0;
+
+        for (int i = 0; i < a.count; i++) {
+            if (std::find(b.cells, b.cells + b.count, a.cells[i]) == b.cells + b.count) {
+                onlyA[onlyACount++] = a.cells[i];
+            }
+        }
+        for (int i = 0; i < b.count; i++) {
+            if (std::find(a.cells, a.cells + a.count, b.cells[i]) == a.cells + a.count) {
+                onlyB[onlyBCount++] = b.cells[i];
+            }
+        }
+
+        if (onlyACount == a.count || onlyBCount == 0) {
+            return false;
+        }
+
+        if (b.mines - a.mines == onlyBCount) {
+            for (int i = 0; i < onlyBCount; i++) {
+                markMine(grid, onlyB[i]);
+            }
+            for (int i = 0; i < onlyACount; i++) {
+                markSafe(grid, onlyA[i]);
+            }
+            return true;
+        }
+
+        if (onlyACount == 0 && b.mines == a.mines) {
+            for (int i = 0; i < onlyBCount; i++) {
+                markSafe(grid, onlyB[i]);
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    void FrontierSolver::markSafe(const Grid::Grid& grid, int cell) {
+        if (deduced[cell] == UNKNOWN) {
+            deduced[cell] = DEDUCED_SAFE;
+            safeMoves.push_back(cell);
+            enqueueNumberNeighbors(grid, cell);
+        }
+    }
+
+    void FrontierSolver::markMine(const Grid::Grid& grid, int cell) {
+        if (deduced[cell] == UNKNOWN) {
+            deduced[cell] = DEDUCED_MINE;
+            mineMoves.push_back(cell);
+            enqueueNumberNeighbors(grid, cell);
+        }
+    }
+
+    // swap removal keeps membership changes O(1)
+    void FrontierSolver::setFrontier(int cell, bool member) {
+        if (member && frontierPos[cell] < 0) {
+            frontierPos[cell] = static_cast<int>(frontier.size());
+            frontier.push_back(cell);
+        } else if (!member && frontierPos[cell] >= 0) {
+            const int last = frontier.back();
+            frontier[frontierPos[cell]] = last;
+            frontierPos[last] = frontierPos[cell];
+            frontier.pop_back();
+            frontierPos[cell] = -1;
+        }
+    }
+
+    bool FrontierSolver::guess(const Grid::Grid& grid, Grid::ActionBatch& actions) {
+
+        int best = -1;
+        float bestRatio = 2.0f;
+        for (int cell : frontier) {
+            const Constraint constraint = getConstraint(grid, cell);
+            if (constraint.count > 0 && static_cast<float>(constraint.mines) / constraint.count < bestRatio) {
+                bestRatio = static_cast<float>(constraint.mines) / constraint.count;
+                best = constraint.cells[0];
+            }
+        }
+
+        // a blind interior cell beats a frontier cell that is likelier a mine than the board average
+        // signed, wrong user flags can outnumber the mines
+        const std::int64_t flagged = static_cast<std::int64_t>(grid.getFlaggedPlane().count());
+        const std::int64_t minesLeft = std::max<std::int64_t>(grid.getMineNum() - flagged, 0);
+        const std::int64_t hidden = grid.getSafeCellsLeft() + minesLeft;
+        const float interiorRatio = hidden > 0 ? static_cast<float>(minesLeft) / static_cast<float>(hidden) : 1.0f;
+        if (best < 0 || interiorRatio < bestRatio) {
+            const int interior = findInteriorCell(grid);
+            if (interior >= 0) {
+                best = interior;
+            }
+        }
+
+        if (best < 0) {
+            return false;
+        }
+
+        actions.reveals.push_back(best);
+        Highlight::queueHighlightTile(best % width, best / width);
+        return true;
+    }
+
+    int FrontierSolver::findInteriorCell(const Grid::Grid& grid) const {
+
+        auto isInterior = [&](int cell) {
+            if (grid.isRevealed(cell % width, cell / width) || grid.isFlagged(cell % width, cell / width)) {
+                return false;
+            }
+            bool touchesNumber = false;
+            forNeighbors(cell, width, height, [&](int neighbor) {
+                touchesNumber |= frontierPos[neighbor] >= 0;
+            });
+            return !touchesNumber;
+        };
+
+        const int corners[4] = {0, width - 1, (height - 1) * width, height * width - 1};
+        for (int corner : corners) {
+            if (isInterior(corner)) {
+                return corner;
+            }
+        }
+
+        // hidden cells a word at a time, most words are fully revealed late in a board
+        const Bitboard::Bitplane& revealed = grid.getRevealedPlane();
+        const Bitboard::Bitplane& flagged = grid.getFlaggedPlane();
+        for (int y = 0; y < height; y++) {
+            for (int w = 0; w < revealed.getRowWords(); w++) {
+                std::uint64_t hidden = ~(revealed.row(y)[w] | flagged.row(y)[w]);
+                if (w == revealed.getRowWords() - 1) {
+                    hidden &= revealed.getTailMask();
+                }
+                for (; hidden != 0; hidden &= hidden - 1) {
+                    const int cell = y * width + (w << 6) + std::countr_zero(hidden);
+                    if (isInterior(cell)) {
+                        return cell;
+                    }
+                }
+            }
+        }
+
+        return -1;
+    }
+
+    int FrontierSolver::getSteps() {
+        return steps;
+    }
+
+    void FrontierSolver::reset() {
+        x = 0;
+        y = 0;
+        steps = 0;
+        frontier.clear();
+        worklist.clear();
+        safeMoves.clear();
+        mineMoves.clear();
+        journalCursor = {};
+        started = false;
+    }
+
+    std::string FrontierSolver::getName() {
+        return name;
+    }
+
+} // algorithmfrontier
@@ -6,7 +6,7 @@
 
 
 #include "dansweeperml/core/grid.h"
-#include "dansweeperml/core/render.h"
+#include "dansweeperml/core/highlight.h"
 #include <dansweeperml/solver/isolver.h>
 
 // THIS IS A TEST THAT IT MULTHREAD WITH HIGHLIGHTING WORKS
@@ -14,16 +14,16 @@ namespace algorithmlinearscan {
 
     bool LinearScan::step(Grid::Grid& grid) {
         x++;
-        if (x > grid.getMetadata().width - 1) {
+        if (x > grid.getWidth() - 1) {
             y++;
             x = 0;
         }
 
-        if (y > grid.getMetadata().height - 1) {
+        if (y > grid.getHeight() - 1) {
             reset();
         }
 
-        Render::queueHighlightTile(x, y);
+        Highlight::queueHighlightTile(x, y);
         grid.reveal(x, y);
 
         steps++;
@@ -0,0 +1,317 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/solver/algorithm/pattern.h>
+#include <dansweeperml/core/highlight.h>
+
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <span>
+
+namespace algorithmpattern {
+
+    namespace {
+
+        // neighbour slots in row order, slot i of (x, y) is (x + SLOT_DX[i], y + SLOT_DY[i])
+        constexpr int SLOT_DX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+        constexpr int SLOT_DY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+        // a neighbour in base 3, out of bounds and revealed cells are clear
+        enum SlotState {
+            CLEAR = 0,
+            UNKNOWN = 1,
+            FLAG = 2
+        };
+
+        constexpr int CODES = 6561;
+
+        // everything a number's 3x3 neighbourhood says on its own, masks are over slots
+        struct LocalEntry {
+            std::uint8_t unknown;
+            std::int8_t remaining;
+            std::uint8_t safe;
+            std::uint8_t mine;
+        };
+
+        // indexed by number * CODES + neighbourhood code
+        constexpr std::array<LocalEntry, 9 * CODES> LOCAL_TABLE = [] {
+            std::array<LocalEntry, 9 * CODES> table{};
+            for (int number = 0; number <= 8; number++) {
+                for (int code = 0; code < CODES; code++) {
+                    LocalEntry entry{};
+                    int flags = 0;
+                    int rest = code;
+                    for (int slot = 0; slot < 8; slot++, rest /= 3) {
+                        if (rest % 3 == UNKNOWN) {
+                            entry.unknown |= 1 << slot;
+                        } else if (rest % 3 == FLAG) {
+                            flags++;
+                        }
+                    }
+
+                    const int unknowns = std::popcount(entry.unknown);
+                    entry.remaining = static_cast<std::int8_t>(number - flags);
+                    if (unknowns > 0 && entry.remaining == 0) {
+                        entry.safe = entry.unknown;
+                    } else if (unknowns > 0 && entry.remaining == unknowns) {
+                        entry.mine = entry.unknown;
+                    }
+                    table[number * CODES + code] = entry;
+                }
+            }
+            return table;
+        }();
+
+        // a second number at (dx, dy) within two cells, index (dy + 2) * 5 + dx + 2
+        // slots of the first number whose cell the second number also touches
+        constexpr std::array<std::uint8_t, 25> OVERLAP = [] {
+            std::array<std::uint8_t, 25> table{};
+            for (int dy = -2; dy <= 2; dy++) {
+                for (int dx = -2; dx <= 2; dx++) {
+                    for (int slot = 0; slot < 8; slot++) {
+                        const int px = SLOT_DX[slot] - dx;
+                        const int py = SLOT_DY[slot] - dy;
+                        if ((px != 0 || py != 0) && px >= -1 && px <= 1 && py >= -1 && py <= 1) {
+                            table[(dy + 2) * 5 + dx + 2] |= 1 << slot;
+                        }
+                    }
+                }
+            }
+            return table;
+        }();
+
+        enum PairOutcome : std::uint8_t {
+            ONLY_A_SAFE = 1,
+            ONLY_A_MINE = 2,
+            ONLY_B_SAFE = 4,
+            ONLY_B_MINE = 8
+        };
+
+        // remaining mines of a and b, then the sizes of the cells only a has, only b has and both share, each 0 to 8
+        constexpr int pairIndex(int remainingA, int remainingB, int onlyA, int onlyB, int shared) {
+            return (((remainingA * 9 + remainingB) * 9 + onlyA) * 9 + onlyB) * 9 + shared;
+        }
+
+        // the subset rules both ways round
+        // b minus a holds remainingB - remainingA mines at least, when that fills only b, only a is safe
+        // with a inside b and equal counts only b is safe
+        constexpr std::array<std::uint8_t, 59049> PAIR_TABLE = [] {
+            std::array<std::uint8_t, 59049> table{};
+            for (int ra = 0; ra <= 8; ra++) {
+                for (int rb = 0; rb <= 8; rb++) {
+                    for (int onlyA = 0; onlyA <= 8; onlyA++) {
+                        for (int onlyB = 0; onlyB <= 8; onlyB++) {
+                            for (int shared = 1; shared <= 8; shared++) {
+                                std::uint8_t outcome = 0;
+                                if (onlyB > 0 && rb - ra == onlyB) {
+                                    outcome |= ONLY_B_MINE | ONLY_A_SAFE;
+                                } else if (onlyB > 0 && onlyA == 0 && ra == rb) {
+                                    outcome |= ONLY_B_SAFE;
+                                }
+                                if (onlyA > 0 && ra - rb == onlyA) {
+                                    outcome |= ONLY_A_MINE | ONLY_B_SAFE;
+                                } else if (onlyA > 0 && onlyB == 0 && ra == rb) {
+                                    outcome |= ONLY_A_SAFE;
+                                }
+                                table[pairIndex(ra, rb, onlyA, onlyB, shared)] = outcome;
+                            }
+                        }
+                    }
+                }
+            }
+            return table;
+        }();
+
+        static_assert(LOCAL_TABLE[1 * CODES + 1].mine == 1, "a 1 with one unknown neighbour is that mine");
+        static_assert(OVERLAP[2 * 5 + 3] == 0b11000110, "a right hand neighbour shares the cells above and below both");
+
+        const LocalEntry& localEntry(std::span<const Grid::PackedCell> cells, int x, int y, int width, int height) {
+            int code = 0;
+            int weight = 1;
+            for (int slot = 0; slot < 8; slot++, weight *= 3) {
+                const int nx = x + SLOT_DX[slot];
+                const int ny = y + SLOT_DY[slot];
+                if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
+                    continue;
+                }
+                const Grid::PackedCell cell = cells[ny * width + nx];
+                if (cell & Grid::CellBits::FLAGGED) {
+                    code += FLAG * weight;
+                } else if (!(cell & Grid::CellBits::REVEALED)) {
+                    code += UNKNOWN * weight;
+                }
+            }
+            return LOCAL_TABLE[(cells[y * width + x] & Grid::CellBits::ADJACENT_MASK) * CODES + code];
+        }
+
+        bool isNumber(Grid::PackedCell cell) {
+            return (cell & Grid::CellBits::REVEALED) && (cell & Grid::CellBits::ADJACENT_MASK) > 0;
+        }
+
+    } // namespace
+
+    bool PatternSolver::step(Grid::Grid& grid) {
+        batch.clear();
+        const bool moved = stepActions(grid, batch);
+        grid.apply(batch);
+        return moved;
+    }
+
+    bool PatternSolver::stepActions(Grid::Grid& grid, Grid::ActionBatch& actions) {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        const size_t cellCount = static_cast<size_t>(meta.width) * meta.height;
+
+        if (queued.size() != cellCount) {
+            queued.assign(cellCount, 0);
+            marked.assign(cellCount, 0);
+            queue.clear();
+            patternCursor = {};
+        }
+
+        collectChanges(grid);
+        while (!queue.empty()) {
+            const int cell = queue.back();
+            queue.pop_back();
+            queued[cell] = 0;
+            lookup(grid, cell);
+        }
+
+        // bfs fills the same batch, so a fallback step is recorded like a table step
+        if (safeMoves.empty() && mineMoves.empty()) {
+            return BFSUnoptimized::stepActions(grid, actions);
+        }
+
+        for (int cell : mineMoves) {
+            marked[cell] = 0;
+            actions.flags.push_back(cell);
+            Highlight::queueHighlightTile(cell % meta.width, cell / meta.width);
+        }
+        for (int cell : safeMoves) {
+            marked[cell] = 0;
+            actions.reveals.push_back(cell);
+            Highlight::queueHighlightTile(cell % meta.width, cell / meta.width);
+        }
+        safeMoves.clear();
+        mineMoves.clear();
+
+        steps++;
+        return true;
+    }
+
+    // a reveal or flag changes the neighbourhood code of the numbers around it
+    void PatternSolver::collectChanges(Grid::Grid& grid) {
+
+        std::span<const Grid::CellDelta> changes;
+        if (grid.readJournal(patternCursor, changes)) {
+            for (const Grid::CellDelta& change : changes) {
+                if ((change.before ^ change.after) & (Grid::CellBits::REVEALED | Grid::CellBits::FLAGGED)) {
+                    enqueueAround(grid, static_cast<int>(change.index));
+                }
+            }
+        } else {
+            grid.getRevealedPlane().forEachSet([&](int x, int y) {
+                enqueueAround(grid, grid.index(x, y));
+            });
+        }
+    }
+
+    void PatternSolver::enqueueAround(const Grid::Grid& grid, int cell) {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        const std::span<const Grid::PackedCell> cells = grid.getCells();
+        const int x = cell % meta.width;
+        const int y = cell / meta.width;
+
+        for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, meta.height - 1); ny++) {
+            for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, meta.width - 1); nx++) {
+                const int number = ny * meta.width + nx;
+                if (!queued[number] && isNumber(cells[number])) {
+                    queued[number] = 1;
+                    queue.push_back(number);
+                }
+            }
+        }
+    }
+
+    // the 3x3 table first, then the pair table against every number in the 5x5 window
+    void PatternSolver::lookup(const Grid::Grid& grid, int cell) {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        const std::span<const Grid::PackedCell> cells = grid.getCells();
+        const int x = cell % meta.width;
+        const int y = cell / meta.width;
+
+        auto markSlots = [&](int cx, int cy, std::uint8_t slots, bool mine) {
+            for (; slots != 0; slots &= slots - 1) {
+                const int slot = std::countr_zero(slots);
+                mark((cy + SLOT_DY[slot]) * meta.width + cx + SLOT_DX[slot], mine);
+            }
+        };
+
+        const LocalEntry& a = localEntry(cells, x, y, meta.width, meta.height);
+        if (a.unknown == 0) {
+            return;
+        }
+        if (a.safe != 0 || a.mine != 0) {
+            markSlots(x, y, a.safe, false);
+            markSlots(x, y, a.mine, true);
+            return;
+        }
+        if (a.remaining < 0 || a.remaining > 8) {
+            return;
+        }
+
+        for (int dy = -2; dy <= 2; dy++) {
+            for (int dx = -2; dx <= 2; dx++) {
+                const int bx = x + dx;
+                const int by = y + dy;
+                if ((dx == 0 && dy == 0) || bx < 0 || bx >= meta.width || by < 0 || by >= meta.height || !isNumber(cells[by * meta.width + bx])) {
+                    continue;
+                }
+
+                const std::uint8_t overlapA = OVERLAP[(dy + 2) * 5 + dx + 2];
+                const std::uint8_t shared = a.unknown & overlapA;
+                if (shared == 0) {
+                    continue;
+                }
+
+                const LocalEntry& b = localEntry(cells, bx, by, meta.width, meta.height);
+                if (b.remaining < 0 || b.remaining > 8) {
+                    continue;
+                }
+
+                const std::uint8_t onlyA = a.unknown & ~overlapA;
+                const std::uint8_t onlyB = b.unknown & ~OVERLAP[(2 - dy) * 5 + 2 - dx];
+                const std::uint8_t outcome = PAIR_TABLE[pairIndex(a.remaining, b.remaining,
+                                                                  std::popcount(onlyA), std::popcount(onlyB), std::popcount(shared))];
+
+                markSlots(x, y, onlyA & (outcome & ONLY_A_SAFE ? 0xFF : 0), false);
+                markSlots(x, y, onlyA & (outcome & ONLY_A_MINE ? 0xFF : 0), true);
+                markSlots(bx, by, onlyB & (outcome & ONLY_B_SAFE ? 0xFF : 0), false);
+                markSlots(bx, by, onlyB & (outcome & ONLY_B_MINE ? 0xFF : 0), true);
+            }
+        }
+    }
+
+    void PatternSolver::mark(int cell, bool mine) {
+        if (!marked[cell]) {
+            marked[cell] = 1;
+            (mine ? mineMoves : safeMoves).push_back(cell);
+        }
+    }
+
+    void PatternSolver::reset() {
+        BFSUnoptimized::reset();
+        patternCursor = {};
+        queue.clear();
+        queued.clear();
+        marked.clear();
+        safeMoves.clear();
+        mineMoves.clear();
+    }
+
+    std::string PatternSolver::getName() {
+        return name;
+    }
+
+} // algorithmpattern
@@ -0,0 +1,636 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/solver/algorithm/probability.h>
+#include <dansweeperml/core/highlight.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace algorithmprobability {
+
+    // probabilities this close to 0 or 1 are certain, anything else is rounding
+    static constexpr double CERTAIN = 1e-12;
+
+    // nodes are taken from the shared budget in blocks so workers rarely touch the atomic
+    static constexpr std::int64_t BUDGET_BLOCK = 4096;
+
+    namespace {
+
+        class Enumerator {
+        public:
+
+            Enumerator(const Component& component, ComponentResult& result, SearchBudget& budget)
+                : component(component), result(result), budget(budget),
+                  mines(component.targets.size(), 0), left(component.targets.size(), 0) {
+
+                for (size_t c = 0; c < component.constraintVars.size(); c++) {
+                    left[c] = static_cast<int>(component.constraintVars[c].size());
+                }
+                mineStack.reserve(component.cells.size());
+            }
+
+            bool run(size_t var) {
+
+                if (var == component.cells.size()) {
+                    const size_t stride = component.cells.size() + 1;
+                    const size_t m = mineStack.size();
+                    result.ways[m] += 1.0;
+                    for (int mine : mineStack) {
+                        result.cellWays[mine * stride + m] += 1.0;
+                    }
+                    return true;
+                }
+
+                for (int value = 0; value <= 1; value++) {
+                    if (!takeNode()) {
+                        return false;
+                    }
+
+                    if (assign(var, value)) {
+                        if (value) {
+                            mineStack.push_back(static_cast<int>(var));
+                        }
+                        const bool finished = run(var + 1);
+                        if (value) {
+                            mineStack.pop_back();
+                        }
+                        if (!finished) {
+                            unassign(var, value);
+                            return false;
+                        }
+                    }
+                    unassign(var, value);
+                }
+
+                return true;
+            }
+
+            // assigns one of the leading variables a split pinned, false when that contradicts a constraint
+            bool pin(size_t var, int value) {
+                if (value) {
+                    mineStack.push_back(static_cast<int>(var));
+                }
+                return assign(var, value);
+            }
+
+        private:
+
+            const Component& component;
+            ComponentResult& result;
+            SearchBudget& budget;
+            std::int64_t allowance = 0;
+            std::vector<int> mines;
+            std::vector<int> left;
+            std::vector<int> mineStack;
+
+            bool takeNode() {
+                if (allowance == 0) {
+                    if (budget.deadline.expired() || budget.nodes.fetch_sub(BUDGET_BLOCK, std::memory_order_relaxed) < BUDGET_BLOCK) {
+                        return false;
+                    }
+                    allowance = BUDGET_BLOCK;
+                }
+                allowance--;
+                return true;
+            }
+
+            // every constraint of the variable must still be reachable after the assignment
+            bool assign(size_t var, int value) {
+                bool valid = true;
+                for (int c : component.varConstraints[var]) {
+                    left[c]--;
+                    mines[c] += value;
+                    valid &= mines[c] <= component.targets[c] && mines[c] + left[c] >= component.targets[c];
+                }
+                return valid;
+            }
+
+            void unassign(size_t var, int value) {
+                for (int c : component.varConstraints[var]) {
+                    left[c]++;
+                    mines[c] -= value;
+                }
+            }
+        };
+
+        // log of n choose k, -inf outside the valid range
+        double logChoose(std::int64_t n, std::int64_t k) {
+            if (k < 0 || k > n) {
+                return -std::numeric_limits<double>::infinity();
+            }
+            return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+        }
+
+        // rescales so the largest entry is 1, every use is a ratio within one component
+        void normalize(std::vector<double>& values) {
+            const double peak = values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+            if (peak > 0.0) {
+                for (double& value : values) {
+                    value /= peak;
+                }
+            }
+        }
+
+    } // namespace
+
+    bool enumerateComponent(const Component& component, ComponentResult& result,
+                            SearchBudget& budget, std::span<const std::uint8_t> fixed) {
+        const size_t stride = component.cells.size() + 1;
+        result.ways.resize(stride, 0.0);
+        result.cellWays.resize(component.cells.size() * stride, 0.0);
+
+        Enumerator enumerator(component, result, budget);
+        for (size_t var = 0; var < fixed.size(); var++) {
+            if (!enumerator.pin(var, fixed[var])) {
+                return true;
+            }
+        }
+        return enumerator.run(fixed.size());
+    }
+
+    ProbabilitySolver::ProbabilitySolver(unsigned threads) {
+        if (threads > 1) {
+            name = "probability parallel";
+            pool = std::make_unique<Sim::ThreadPool>(threads);
+            // a couple of pieces per thread so uneven pieces still balance
+            splitDepth = std::bit_width(threads * 2 - 1);
+        }
+    }
+
+    void ProbabilitySolver::buildComponents(const Grid::Grid& grid) {
+
+        // board order, so a component no move touched comes out identical to the last step
+        std::vector<int> numbers(frontier);
+        std::sort(numbers.begin(), numbers.end());
+
+        std::vector<Constraint> constraints;
+        constraints.reserve(numbers.size());
+        for (int cell : numbers) {
+            constraints.push_back(getConstraint(grid, cell));
+        }
+
+        // global variable ids, then union find over variables sharing a constraint
+        varOf.resize(static_cast<size_t>(width) * height, -1);
+        std::vector<int> varCells;
+        for (const Constraint& constraint : constraints) {
+            for (int i = 0; i < constraint.count; i++) {
+                if (varOf[constraint.cells[i]] < 0) {
+                    varOf[constraint.cells[i]] = static_cast<int>(varCells.size());
+                    varCells.push_back(constraint.cells[i]);
+                }
+            }
+        }
+
+        std::vector<int> parent(varCells.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](int v) {
+            while (parent[v] != v) {
+                parent[v] = parent[parent[v]];
+                v = parent[v];
+            }
+            return v;
+        };
+
+        for (const Constraint& constraint : constraints) {
+            for (int i = 1; i < constraint.count; i++) {
+                parent[find(varOf[constraint.cells[i]])] = find(varOf[constraint.cells[0]]);
+            }
+        }
+
+        // constraints of each component, by root variable
+        std::vector<int> componentOf(varCells.size(), -1);
+        std::vector<std::vector<int>> componentConstraints;
+        for (size_t c = 0; c < constraints.size(); c++) {
+            if (constraints[c].count == 0) {
+                continue;
+            }
+            const int root = find(varOf[constraints[c].cells[0]]);
+            if (componentOf[root] < 0) {
+                componentOf[root] = static_cast<int>(componentConstraints.size());
+                componentConstraints.emplace_back();
+            }
+            componentConstraints[componentOf[root]].push_back(static_cast<int>(c));
+        }
+
+        components.assign(componentConstraints.size(), {});
+        std::vector<std::vector<int>> constraintsOfVar(varCells.size());
+        std::vector<int> localOf(varCells.size(), -1);
+
+        for (size_t j = 0; j < components.size(); j++) {
+            Component& component = components[j];
+
+            for (int c : componentConstraints[j]) {
+                for (int i = 0; i < constraints[c].count; i++) {
+                    constraintsOfVar[varOf[constraints[c].cells[i]]].push_back(c);
+                }
+            }
+
+            // breadth first from the most constrained variable, constraints close early and prune early
+            int start = varOf[constraints[componentConstraints[j].front()].cells[0]];
+            for (int c : componentConstraints[j]) {
+                for (int i = 0; i < constraints[c].count; i++) {
+                    const int var = varOf[constraints[c].cells[i]];
+                    if (constraintsOfVar[var].size() > constraintsOfVar[start].size()) {
+                        start = var;
+                    }
+                }
+            }
+
+            std::vector<int> order{start};
+            localOf[start] = 0;
+            for (size_t head = 0; head < order.size(); head++) {
+                for (int c : constraintsOfVar[order[head]]) {
+                    for (int i = 0; i < constraints[c].count; i++) {
+                        const int var = varOf[constraints[c].cells[i]];
+                        if (localOf[var] < 0) {
+                            localOf[var] = static_cast<int>(order.size());
+                            order.push_back(var);
+                        }
+                    }
+                }
+            }
+
+            component.cells.resize(order.size());
+            component.varConstraints.assign(order.size(), {});
+            for (size_t v = 0; v < order.size(); v++) {
+                component.cells[v] = varCells[order[v]];
+            }
+
+            for (int c : componentConstraints[j]) {
+                const int local = static_cast<int>(component.targets.size());
+                component.targets.push_back(constraints[c].mines);
+                component.constraintVars.emplace_back();
+                for (int i = 0; i < constraints[c].count; i++) {
+                    const int var = localOf[varOf[constraints[c].cells[i]]];
+                    component.constraintVars.back().push_back(var);
+                    component.varConstraints[var].push_back(local);
+                }
+            }
+        }
+
+        for (int cell : varCells) {
+            varOf[cell] = -1;
+        }
+    }
+
+    void ProbabilitySolver::matchProgress() {
+
+        // several pieces per large component, on one thread only when a step budget may cut them off
+        const int depth = pool ? splitDepth : (stepBudget.count() > 0 ? RESUME_SPLIT_DEPTH : 0);
+
+        std::vector<Progress> previous;
+        previous.swap(progress);
+        std::unordered_map<int, size_t> byFirstCell;
+        for (size_t i = 0; i < previous.size(); i++) {
+            byFirstCell.emplace(previous[i].component.cells.front(), i);
+        }
+
+        progress.resize(components.size());
+        for (size_t j = 0; j < components.size(); j++) {
+            const auto it = byFirstCell.find(components[j].cells.front());
+            if (it != byFirstCell.end() && previous[it->second].component == components[j]) {
+                progress[j] = std::move(previous[it->second]);
+                if (progress[j].complete || progress[j].depth == (components[j].cells.size() >= SPLIT_VARIABLES ? depth : 0)) {
+                    continue;
+                }
+            }
+
+            Progress& fresh = progress[j];
+            fresh = {};
+            fresh.component = components[j];
+            fresh.depth = components[j].cells.size() >= SPLIT_VARIABLES ? depth : 0;
+            fresh.finished.assign(size_t{1} << fresh.depth, 0);
+            fresh.result.ways.assign(components[j].cells.size() + 1, 0.0);
+            fresh.result.cellWays.assign(components[j].cells.size() * (components[j].cells.size() + 1), 0.0);
+        }
+    }
+
+    bool ProbabilitySolver::solveComponents() {
+        SearchBudget budget{NODE_BUDGET, deadline};
+        matchProgress();
+
+        // a large component becomes one piece per assignment of its first depth variables
+        // enumeration order starts at the most constrained variable, so the pieces are pruned early
+        struct Piece {
+            size_t component;
+            size_t bits;
+            ComponentResult result;
+            bool done = false;
+        };
+
+        std::vector<Piece> pieces;
+        for (size_t j = 0; j < components.size(); j++) {
+            for (size_t bits = 0; bits < progress[j].finished.size() && !progress[j].complete; bits++) {
+                if (!progress[j].finished[bits]) {
+                    pieces.push_back({j, bits, {}});
+                }
+            }
+        }
+
+        auto runPiece = [this, &budget](Piece& piece) {
+            std::vector<std::uint8_t> fixed(progress[piece.component].depth);
+            for (size_t var = 0; var < fixed.size(); var++) {
+                fixed[var] = static_cast<std::uint8_t>(piece.bits >> var & 1);
+            }
+            piece.done = enumerateComponent(components[piece.component], piece.result, budget, fixed);
+        };
+
+        if (!pool) {
+            for (Piece& piece : pieces) {
+                runPiece(piece);
+                if (!piece.done) {
+                    break;
+                }
+            }
+        } else {
+            Sim::TaskGroup group(*pool);
+
+            // split components go one piece per task, small components in batches
+            // since one task each would cost more than enumerating them
+            for (size_t begin = 0; begin < pieces.size();) {
+                size_t end = begin;
+                size_t variables = 0;
+                while (end < pieces.size() && variables < SPLIT_VARIABLES) {
+                    variables += components[pieces[end].component].cells.size();
+                    end++;
+                }
+
+                group.run([&pieces, &runPiece, begin, end] {
+                    for (size_t i = begin; i < end; i++) {
+                        runPiece(pieces[i]);
+                    }
+                });
+                begin = end;
+            }
+
+            group.wait();
+        }
+
+        // counts of the pieces of a component add up to the counts of the whole, unfinished pieces are dropped
+        for (const Piece& piece : pieces) {
+            if (!piece.done) {
+                continue;
+            }
+            Progress& counted = progress[piece.component];
+            for (size_t m = 0; m < counted.result.ways.size(); m++) {
+                counted.result.ways[m] += piece.result.ways[m];
+            }
+            for (size_t i = 0; i < counted.result.cellWays.size(); i++) {
+                counted.result.cellWays[i] += piece.result.cellWays[i];
+            }
+            counted.finished[piece.bits] = 1;
+        }
+
+        bool complete = true;
+        results.resize(components.size());
+        for (size_t j = 0; j < components.size(); j++) {
+            Progress& counted = progress[j];
+            counted.complete = std::find(counted.finished.begin(), counted.finished.end(), 0) == counted.finished.end();
+            complete &= counted.complete;
+            results[j] = counted.result;
+        }
+
+        return complete;
+    }
+
+    // with D_j the mine count distribution of component j and w(k) the interior ways for k frontier mines
+    // the weight of component j having m mines is G_j[m] = sum over a of prefix_j[a] * T_j[m + a]
+    // prefix_j is D_0 * ... * D_(j-1) and T_j[t] = sum over m of D_(j+1)[m] * T_(j+1)[t + m], T_last = w
+    // one forward and one backward pass instead of convolving all other components for every j
+    double ProbabilitySolver::combine(const Grid::Grid& grid) {
+
+        std::int64_t minesLeft = 0;
+        std::int64_t interior = 0;
+        countUnknowns(grid, minesLeft, interior);
+
+        size_t total = 0;
+        for (const Component& component : components) {
+            total += component.cells.size();
+        }
+
+        std::vector<double> weights(total + 1);
+        double peak = -std::numeric_limits<double>::infinity();
+        for (size_t k = 0; k <= total; k++) {
+            weights[k] = logChoose(interior, minesLeft - static_cast<std::int64_t>(k));
+            peak = std::max(peak, weights[k]);
+        }
+        if (peak == -std::numeric_limits<double>::infinity()) {
+            return -1.0;
+        }
+        for (double& weight : weights) {
+            weight = std::exp(weight - peak);
+        }
+
+        for (ComponentResult& result : results) {
+            const double scale = *std::max_element(result.ways.begin(), result.ways.end());
+            if (scale <= 0.0) {
+                return -1.0;
+            }
+            for (double& ways : result.ways) ways /= scale;
+            for (double& ways : result.cellWays) ways /= scale;
+        }
+
+        // forward pass, prefix_j kept for the backward pass
+        std::vector<std::vector<double>> prefixes(components.size() + 1);
+        prefixes[0] = {1.0};
+        for (size_t j = 0; j < components.size(); j++) {
+            const std::vector<double>& previous = prefixes[j];
+            const std::vector<double>& ways = results[j].ways;
+            std::vector<double>& next = prefixes[j + 1];
+            next.assign(previous.size() + ways.size() - 1, 0.0);
+            for (size_t a = 0; a < previous.size(); a++) {
+                for (size_t m = 0; m < ways.size(); m++) {
+                    next[a + m] += previous[a] * ways[m];
+                }
+            }
+            normalize(next);
+        }
+
+        // interior cells share one probability, the expected interior mines over the interior size
+        const std::vector<double>& all = prefixes.back();
+        double totalWeight = 0.0;
+        double interiorMines = 0.0;
+        for (size_t k = 0; k < all.size(); k++) {
+            totalWeight += all[k] * weights[k];
+            interiorMines += all[k] * weights[k] * static_cast<double>(minesLeft - static_cast<std::int64_t>(k));
+        }
+        if (totalWeight <= 0.0) {
+            return -1.0;
+        }
+
+        probabilities.assign(total, 0.0);
+        std::vector<double> tail = weights;
+        std::vector<double> nextTail;
+        size_t offset = total;
+
+        for (size_t j = components.size(); j-- > 0;) {
+            const ComponentResult& result = results[j];
+            const std::vector<double>& prefix = prefixes[j];
+            const size_t stride = result.ways.size();
+            offset -= stride - 1;
+
+            std::vector<double> componentWeight(stride, 0.0);
+            for (size_t m = 0; m < stride; m++) {
+                for (size_t a = 0; a < prefix.size() && a + m < tail.size(); a++) {
+                    componentWeight[m] += prefix[a] * tail[a + m];
+                }
+            }
+
+            double norm = 0.0;
+            for (size_t m = 0; m < stride; m++) {
+                norm += result.ways[m] * componentWeight[m];
+            }
+            if (norm <= 0.0) {
+                return -1.0;
+            }
+
+            for (size_t v = 0; v + 1 < stride; v++) {
+                double mineWeight = 0.0;
+                for (size_t m = 0; m < stride; m++) {
+                    mineWeight += result.cellWays[v * stride + m] * componentWeight[m];
+                }
+                probabilities[offset + v] = mineWeight / norm;
+            }
+
+            // fold this component into the tail for the one before it
+            nextTail.assign(prefix.size(), 0.0);
+            for (size_t t = 0; t < nextTail.size(); t++) {
+                for (size_t m = 0; m < stride && t + m < tail.size(); m++) {
+                    nextTail[t] += result.ways[m] * tail[t + m];
+                }
+            }
+            normalize(nextTail);
+            tail.swap(nextTail);
+        }
+
+        return interior > 0 ? interiorMines / totalWeight / static_cast<double>(interior) : 1.0;
+    }
+
+    void ProbabilitySolver::countUnknowns(const Grid::Grid& grid, std::int64_t& minesLeft, std::int64_t& interior) const {
+        const Grid::GridMetadata& meta = grid.getMetadata();
+        const std::int64_t flagged = static_cast<std::int64_t>(grid.getFlaggedPlane().count());
+        const std::int64_t hidden = static_cast<std::int64_t>(width) * height
+                                    - static_cast<std::int64_t>(grid.getRevealedPlane().count()) - flagged;
+
+        std::int64_t variables = 0;
+        for (const Component& component : components) {
+            variables += static_cast<std::int64_t>(component.cells.size());
+        }
+
+        minesLeft = meta.mineNum - flagged;
+        interior = hidden - variables;
+    }
+
+    bool ProbabilitySolver::estimate(const Grid::Grid& grid, double& interiorProbability) {
+        exact = true;
+        if (!solveComponents()) {
+            return false;
+        }
+        interiorProbability = combine(grid);
+        return interiorProbability >= 0.0;
+    }
+
+    bool ProbabilitySolver::guess(const Grid::Grid& grid, Grid::ActionBatch& actions) {
+
+        buildComponents(grid);
+        double interiorProbability = 0.0;
+        if (!estimate(grid, interiorProbability)) {
+            return playCertainCells(actions) || FrontierSolver::guess(grid, actions);
+        }
+
+        // certain cells the pairwise rules could not see are played together, otherwise the safest cell
+        std::vector<int> safe;
+        std::vector<int> mines;
+        int best = -1;
+        double bestProbability = 2.0;
+
+        size_t v = 0;
+        for (const Component& component : components) {
+            for (int cell : component.cells) {
+                const double probability = probabilities[v++];
+                if (exact && probability < CERTAIN) {
+                    safe.push_back(cell);
+                } else if (exact && probability > 1.0 - CERTAIN) {
+                    mines.push_back(cell);
+                }
+                if (probability < bestProbability) {
+                    bestProbability = probability;
+                    best = cell;
+                }
+            }
+        }
+
+        if (!safe.empty() || !mines.empty()) {
+            playAll(actions, safe, mines);
+            return true;
+        }
+
+        if (best < 0 || interiorProbability < bestProbability) {
+            const int interior = findInteriorCell(grid);
+            if (interior >= 0) {
+                best = interior;
+            }
+        }
+
+        if (best < 0) {
+            return false;
+        }
+
+        actions.reveals.push_back(best);
+        Highlight::queueHighlightTile(best % width, best / width);
+        return true;
+    }
+
+    bool ProbabilitySolver::playCertainCells(Grid::ActionBatch& actions) {
+        std::vector<int> safe;
+        std::vector<int> mines;
+
+        // progress is only current when this guess counted, a sampled guess leaves the last counted one behind
+        for (size_t j = 0; j < progress.size() && j < components.size(); j++) {
+            const Progress& counted = progress[j];
+            const ComponentResult& result = counted.result;
+            const size_t stride = result.ways.size();
+            const double total = std::accumulate(result.ways.begin(), result.ways.end(), 0.0);
+            if (!counted.complete || total <= 0.0 || counted.component != components[j]) {
+                continue;
+            }
+
+            for (size_t v = 0; v + 1 < stride; v++) {
+                const double mineWays = std::accumulate(result.cellWays.begin() + v * stride, result.cellWays.begin() + (v + 1) * stride, 0.0);
+                if (mineWays == 0.0) {
+                    safe.push_back(counted.component.cells[v]);
+                } else if (mineWays == total) {
+                    mines.push_back(counted.component.cells[v]);
+                }
+            }
+        }
+
+        if (safe.empty() && mines.empty()) {
+            return false;
+        }
+        playAll(actions, safe, mines);
+        return true;
+    }
+
+    void ProbabilitySolver::playAll(Grid::ActionBatch& actions, const std::vector<int>& safe, const std::vector<int>& mines) {
+        for (int cell : mines) {
+            actions.flags.push_back(cell);
+            Highlight::queueHighlightTile(cell % width, cell / width);
+        }
+        for (int cell : safe) {
+            actions.reveals.push_back(cell);
+            Highlight::queueHighlightTile(cell % width, cell / width);
+        }
+    }
+
+    std::string ProbabilitySolver::getName() {
+        return name;
+    }
+
+} // algorithmprobability
@@ -0,0 +1,488 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/solver/algorithm/sampling.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace algorithmsampling {
+
+    // nodes one chain may spend looking for a consistent start
+    static constexpr std::int64_t START_BUDGET = 1ll << 20;
+
+    // nodes one move may spend enumerating its block, past that the move changes nothing
+    static constexpr std::int64_t MOVE_NODES = 1ll << 13;
+
+    namespace {
+
+        // log of n choose k, -inf outside the valid range
+        double logChoose(std::int64_t n, std::int64_t k) {
+            if (k < 0 || k > n) {
+                return -std::numeric_limits<double>::infinity();
+            }
+            return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+        }
+
+        // every component flattened, variable ids follow the order of the solver's probabilities
+        struct Model {
+            std::vector<int> targets;
+            std::vector<std::vector<int>> constraintVars;
+            std::vector<std::vector<int>> varConstraints;
+
+            // log ways to fill the interior when the frontier holds k mines
+            std::vector<double> interiorWays;
+            std::int64_t minesLeft = 0;
+            std::int64_t interior = 0;
+        };
+
+        class Chain {
+        public:
+
+            // hints holds a previous placement per variable, 2 where there is none
+            Chain(const Model& model, std::uint64_t seed, int blockVariables, std::vector<std::uint8_t> hints)
+                : hints(std::move(hints)), mineCounts(model.varConstraints.size(), 0.0), model(model), rng(seed), blockVariables(blockVariables),
+                  state(model.varConstraints.size(), 0), sums(model.targets.size(), 0),
+                  mark(model.varConstraints.size(), 0), touchedIndex(model.targets.size(), -1) {}
+
+            // backtracking for the first consistent placement, trying the hinted value first and a random one otherwise
+            bool start() {
+                const size_t variables = state.size();
+                std::vector<int> left(model.targets.size());
+                for (size_t c = 0; c < left.size(); c++) {
+                    left[c] = static_cast<int>(model.constraintVars[c].size());
+                }
+
+                auto assign = [&](size_t var, int value) {
+                    bool valid = true;
+                    for (int c : model.varConstraints[var]) {
+                        left[c]--;
+                        sums[c] += value;
+                        valid &= sums[c] <= model.targets[c] && sums[c] + left[c] >= model.targets[c];
+                    }
+                    return valid;
+                };
+                auto unassign = [&](size_t var, int value) {
+                    for (int c : model.varConstraints[var]) {
+                        left[c]++;
+                        sums[c] -= value;
+                    }
+                };
+
+                // iterative, a giant frontier would recurse too deep for a worker's stack
+                std::vector<std::uint8_t> tried(variables, 0);
+                std::vector<std::uint8_t> first(variables, 0);
+                std::int64_t nodes = START_BUDGET;
+                size_t var = 0;
+
+                while (var < variables) {
+                    if (tried[var] == 2) {
+                        tried[var] = 0;
+                        if (var == 0) {
+                            return false;
+                        }
+                        var--;
+                        unassign(var, state[var]);
+                        continue;
+                    }
+                    if (nodes-- == 0) {
+                        return false;
+                    }
+
+                    if (tried[var] == 0) {
+                        first[var] = hints[var] < 2 ? hints[var] : static_cast<std::uint8_t>(rng() & 1);
+                    }
+                    state[var] = static_cast<std::uint8_t>(first[var] ^ tried[var]);
+                    tried[var]++;
+
+                    if (assign(var, state[var])) {
+                        var++;
+                    } else {
+                        unassign(var, state[var]);
+                    }
+                }
+
+                frontierMines = std::count(state.begin(), state.end(), 1);
+                return true;
+            }
+
+            // mines the frontier holds beyond what the global count allows, 0 once the state is a real board
+            std::int64_t excess(std::int64_t mines) const {
+                return std::max({std::int64_t{0}, model.minesLeft - model.interior - mines, mines - model.minesLeft});
+            }
+
+            bool isFeasible() const {
+                return excess(frontierMines) == 0;
+            }
+
+            void sweep() {
+                // blocks average half the configured size
+                const size_t moves = std::max<size_t>(1, state.size() * 4 / blockVariables);
+                for (size_t i = 0; i < moves; i++) {
+                    move();
+                }
+            }
+
+            void record() {
+                for (size_t v = 0; v < state.size(); v++) {
+                    mineCounts[v] += state[v];
+                }
+                if (model.interior > 0) {
+                    interiorMines += static_cast<double>(model.minesLeft - frontierMines) / static_cast<double>(model.interior);
+                }
+                samples++;
+            }
+
+            const std::vector<std::uint8_t>& getState() const {
+                return state;
+            }
+
+            std::vector<std::uint8_t> hints;
+            std::vector<double> mineCounts;
+            double interiorMines = 0.0;
+            int samples = 0;
+
+        private:
+
+            const Model& model;
+            std::mt19937_64 rng;
+            int blockVariables;
+
+            std::vector<std::uint8_t> state;
+            std::vector<int> sums;
+            std::int64_t frontierMines = 0;
+
+            // scratch for moves, stamps avoid clearing per move
+            std::vector<std::uint32_t> mark;
+            std::uint32_t stamp = 0;
+            std::vector<int> touchedIndex;
+            std::vector<int> touched;
+            std::vector<int> need;
+            std::vector<int> open;
+            std::vector<int> block;
+            std::int64_t nodes = 0;
+            double currentWays = 0.0;
+            bool repairing = false;
+            std::uint64_t chosenMask = 0;
+            std::int64_t chosenMines = 0;
+            double totalWeight = 0.0;
+
+            // resamples a ball of variables around a random seed from its exact conditional given the rest
+            // the ball is grown breadth first over shared constraints, so a chain of linked cells flips together
+            void move() {
+                const int seedVar = static_cast<int>(rng() % state.size());
+                const int size = 1 + static_cast<int>(rng() % blockVariables);
+
+                stamp++;
+                block.clear();
+                block.push_back(seedVar);
+                mark[seedVar] = stamp;
+                for (size_t head = 0; head < block.size() && static_cast<int>(block.size()) < size; head++) {
+                    for (int c : model.varConstraints[block[head]]) {
+                        for (int var : model.constraintVars[c]) {
+                            if (mark[var] != stamp && static_cast<int>(block.size()) < size) {
+                                mark[var] = stamp;
+                                block.push_back(var);
+                            }
+                        }
+                    }
+                }
+
+                // what each touched constraint still needs from the block, with everything outside it fixed
+                touched.clear();
+                need.clear();
+                open.clear();
+                std::int64_t blockMines = 0;
+                for (int var : block) {
+                    blockMines += state[var];
+                    for (int c : model.varConstraints[var]) {
+                        if (touchedIndex[c] < 0) {
+                            touchedIndex[c] = static_cast<int>(touched.size());
+                            touched.push_back(c);
+                            need.push_back(model.targets[c] - sums[c]);
+                            open.push_back(0);
+                        }
+                        need[touchedIndex[c]] += state[var];
+                        open[touchedIndex[c]]++;
+                    }
+                }
+
+                // weights are relative to the current placement, a start the interior cannot complete walks toward one it can
+                currentWays = model.interiorWays[frontierMines];
+                repairing = currentWays == -std::numeric_limits<double>::infinity();
+                nodes = MOVE_NODES;
+                totalWeight = 0.0;
+                chosenMask = 0;
+                chosenMines = frontierMines;
+
+                // the candidates depend only on the block and what is outside it, so giving up is the same
+                // from every placement the move could reach and the chain stays reversible
+                const bool complete = enumerate(0, 0, frontierMines - blockMines);
+
+                for (int c : touched) {
+                    touchedIndex[c] = -1;
+                }
+                if (!complete || totalWeight <= 0.0) {
+                    return;
+                }
+
+                for (size_t i = 0; i < block.size(); i++) {
+                    const int var = block[i];
+                    const std::uint8_t value = chosenMask >> i & 1;
+                    if (value != state[var]) {
+                        for (int c : model.varConstraints[var]) {
+                            sums[c] += value - state[var];
+                        }
+                        state[var] = value;
+                    }
+                }
+                frontierMines = chosenMines;
+            }
+
+            // pruned backtracking over the block, one weighted reservoir pick instead of storing every candidate
+            bool enumerate(size_t i, std::uint64_t mask, std::int64_t mines) {
+                if (i == block.size()) {
+                    const double weight = repairing
+                        ? std::exp(-static_cast<double>(excess(mines)))
+                        : std::exp(std::min(model.interiorWays[mines] - currentWays, 700.0));
+                    totalWeight += weight;
+                    if (weight > 0.0 && std::uniform_real_distribution<double>(0.0, totalWeight)(rng) < weight) {
+                        chosenMask = mask;
+                        chosenMines = mines;
+                    }
+                    return true;
+                }
+
+                for (int value = 0; value <= 1; value++) {
+                    if (nodes-- == 0) {
+                        return false;
+                    }
+
+                    bool valid = true;
+                    for (int c : model.varConstraints[block[i]]) {
+                        const int t = touchedIndex[c];
+                        open[t]--;
+                        need[t] -= value;
+                        valid &= need[t] >= 0 && need[t] <= open[t];
+                    }
+                    const bool finished = !valid || enumerate(i + 1, mask | static_cast<std::uint64_t>(value) << i, mines + value);
+                    for (int c : model.varConstraints[block[i]]) {
+                        const int t = touchedIndex[c];
+                        open[t]++;
+                        need[t] += value;
+                    }
+                    if (!finished) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+        // largest Gelman-Rubin potential scale reduction over the variables
+        // a mine indicator's within chain variance is p (1 - p)
+        // chains cut off by the step budget may hold a few samples less, n is their mean
+        double largestRhat(const std::vector<Chain>& chains) {
+            double n = 0.0;
+            for (const Chain& chain : chains) {
+                if (chain.samples < 2) {
+                    return std::numeric_limits<double>::infinity();
+                }
+                n += chain.samples;
+            }
+            const double m = static_cast<double>(chains.size());
+            n /= m;
+
+            double worst = 1.0;
+            for (size_t v = 0; v < chains.front().mineCounts.size(); v++) {
+                double meanOfMeans = 0.0;
+                double within = 0.0;
+                for (const Chain& chain : chains) {
+                    const double p = chain.mineCounts[v] / chain.samples;
+                    meanOfMeans += p;
+                    within += p * (1.0 - p) * chain.samples / (chain.samples - 1.0);
+                }
+                meanOfMeans /= m;
+                within /= m;
+
+                double between = 0.0;
+                for (const Chain& chain : chains) {
+                    const double p = chain.mineCounts[v] / chain.samples;
+                    between += (p - meanOfMeans) * (p - meanOfMeans);
+                }
+                between /= m - 1.0;
+
+                // every chain stuck on one value, they only agree if it is the same value
+                if (within <= 0.0) {
+                    if (between > 0.0) {
+                        return std::numeric_limits<double>::infinity();
+                    }
+                    continue;
+                }
+                worst = std::max(worst, std::sqrt(((n - 1.0) / n * within + between) / within));
+            }
+            return worst;
+        }
+
+    } // namespace
+
+    SamplingSolver::SamplingSolver(unsigned threads, SamplingConfig config)
+        : ProbabilitySolver(threads), config(config) {
+        if (threads > 1) {
+            name = "sampling parallel";
+        }
+    }
+
+    bool SamplingSolver::estimate(const Grid::Grid& grid, double& interiorProbability) {
+        size_t largest = 0;
+        for (const algorithmprobability::Component& component : components) {
+            largest = std::max(largest, component.cells.size());
+        }
+
+        if (largest <= config.enumerationVariables && ProbabilitySolver::estimate(grid, interiorProbability)) {
+            return true;
+        }
+
+        exact = false;
+        return sample(grid, interiorProbability);
+    }
+
+    bool SamplingSolver::sample(const Grid::Grid& grid, double& interiorProbability) {
+
+        Model model;
+        countUnknowns(grid, model.minesLeft, model.interior);
+
+        size_t variables = 0;
+        for (const algorithmprobability::Component& component : components) {
+            for (size_t c = 0; c < component.targets.size(); c++) {
+                model.targets.push_back(component.targets[c]);
+                model.constraintVars.emplace_back();
+                for (int var : component.constraintVars[c]) {
+                    model.constraintVars.back().push_back(static_cast<int>(variables) + var);
+                }
+            }
+            for (size_t v = 0; v < component.cells.size(); v++) {
+                model.varConstraints.emplace_back();
+                for (int c : component.varConstraints[v]) {
+                    model.varConstraints.back().push_back(static_cast<int>(model.targets.size() - component.targets.size()) + c);
+                }
+            }
+            variables += component.cells.size();
+        }
+        if (variables == 0) {
+            return false;
+        }
+
+        model.interiorWays.resize(variables + 1);
+        for (size_t k = 0; k <= variables; k++) {
+            model.interiorWays[k] = logChoose(model.interior, model.minesLeft - static_cast<std::int64_t>(k));
+        }
+
+        const unsigned chainCount = std::max(config.chains, 2u);
+        const int blockVariables = std::clamp(config.blockVariables, 1, 64);
+        std::vector<Chain> chains;
+        chains.reserve(chainCount);
+        draws++;
+        warm.resize(chainCount);
+        for (unsigned c = 0; c < chainCount; c++) {
+            warm[c].resize(static_cast<size_t>(width) * height, 2);
+            std::vector<std::uint8_t> hints;
+            hints.reserve(variables);
+            for (const algorithmprobability::Component& component : components) {
+                for (int cell : component.cells) {
+                    hints.push_back(warm[c][cell]);
+                }
+            }
+            chains.emplace_back(model, config.seed ^ (draws * 0x9e3779b97f4a7c15ull + c), blockVariables, std::move(hints));
+        }
+
+        auto forEachChain = [&](auto&& work) {
+            if (!pool) {
+                for (Chain& chain : chains) {
+                    work(chain);
+                }
+                return;
+            }
+            Sim::TaskGroup group(*pool);
+            for (Chain& chain : chains) {
+                group.run([&work, &chain] { work(chain); });
+            }
+            group.wait();
+        };
+
+        std::vector<char> started(chainCount, 0);
+        forEachChain([&](Chain& chain) {
+            if (chain.start()) {
+                for (int s = 0; s < config.burnInSweeps && !deadline.expired(); s++) {
+                    chain.sweep();
+                }
+                started[&chain - chains.data()] = chain.isFeasible();
+            }
+        });
+        if (std::find(started.begin(), started.end(), 0) != started.end()) {
+            return false;
+        }
+
+        // past the deadline every chain still records one sample, the estimate so far is the move
+        for (int round = 0; round < std::max(config.maxRounds, 1); round++) {
+            forEachChain([&](Chain& chain) {
+                for (int s = 0; s < config.roundSweeps && (s == 0 || !deadline.expired()); s++) {
+                    chain.sweep();
+                    chain.record();
+                }
+            });
+
+            lastRhat = largestRhat(chains);
+            if (lastRhat <= config.targetRhat || deadline.expired()) {
+                break;
+            }
+        }
+
+        // the next guess starts its chains from these placements, most of the frontier is still there
+        for (unsigned c = 0; c < chainCount; c++) {
+            size_t v = 0;
+            for (const algorithmprobability::Component& component : components) {
+                for (int cell : component.cells) {
+                    warm[c][cell] = chains[c].getState()[v++];
+                }
+            }
+        }
+
+        double samples = 0.0;
+        for (const Chain& chain : chains) {
+            samples += chain.samples;
+        }
+        probabilities.assign(variables, 0.0);
+        interiorProbability = 0.0;
+        for (const Chain& chain : chains) {
+            for (size_t v = 0; v < variables; v++) {
+                probabilities[v] += chain.mineCounts[v] / samples;
+            }
+            interiorProbability += chain.interiorMines / samples;
+        }
+        if (model.interior == 0) {
+            interiorProbability = 1.0;
+        }
+
+        return true;
+    }
+
+    double SamplingSolver::getLastRhat() const {
+        return lastRhat;
+    }
+
+    void SamplingSolver::reset() {
+        ProbabilitySolver::reset();
+        warm.clear();
+        draws = 0;
+        lastRhat = 0.0;
+    }
+
+    std::string SamplingSolver::getName() {
+        return name;
+    }
+
+} // algorithmsampling
@@ -5,7 +5,7 @@
 #include <dansweeperml/solver/ml/linearregression/linearregressiontrainer.h>
 #include <filesystem>
 
-#include "dansweeperml/core/render.h"
+#include "dansweeperml/core/highlight.h"
 #include "dansweeperml/solver/ml/linearregression/features.h"
 
 namespace mllinearregressiontrainer {
@@ -16,14 +16,14 @@ namespace mllinearregressiontrainer {
    }
 
    bool LinearRegressionTrainer::step(Grid::Grid& grid) {
-      auto meta = grid.getMetadata();
-      auto& cells = grid.getCells();
+      const int width = grid.getWidth();
+      const int height = grid.getHeight();
 
       // Pick a random unrevealed, unflagged cell
       std::vector<std::pair<int,int>> candidates;
-      for (int y = 0; y < meta.height; ++y)
-         for (int x = 0; x < meta.width; ++x)
-            if (!cells[y][x].revealed && !cells[y][x].flagged)
+      for (int y = 0; y < height; ++y)
+         for (int x = 0; x < width; ++x)
+            if (!grid.isRevealed(x, y) && !grid.isFlagged(x, y))
                candidates.emplace_back(x, y);
 
       if (candidates.empty()) return false;
@@ -37,13 +37,12 @@ namespace mllinearregressiontrainer {
 
       // 2. Act: reveal
       grid.reveal(cx, cy);
-      Render::queueHighlightTile(cx, cy);
+      Highlight::queueHighlightTile(cx, cy);
       ++steps;
 
       // 3. Label after action (safe or mine)
       double label = 1.0;
-      const auto metaAfter = grid.getMetadata();
-      if (metaAfter.gridState == Grid::FINISHED_LOSE)
+      if (grid.getGridState() == Grid::FINISHED_LOSE)
          label = 0.0;
 
       appendSample(feat, label);
@@ -0,0 +1,151 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/solver/pacer.h>
+
+#include <algorithm>
+
+void SolverPacer::setMode(PacingMode mode) {
+    {
+        std::lock_guard lk(mtx);
+        this->mode.store(mode, std::memory_order_relaxed);
+        frameCredits = 0;
+        stepRequested = false;
+        woken = false;
+        nextStep = {};
+        version++;
+    }
+    cv.notify_all();
+}
+
+void SolverPacer::setStepsPerSecond(double rate) {
+    {
+        std::lock_guard lk(mtx);
+        stepsPerSecond.store(std::max(rate, 0.001), std::memory_order_relaxed);
+        nextStep = {};
+        version++;
+    }
+    cv.notify_all();
+}
+
+std::chrono::microseconds SolverPacer::getStepBudget() const {
+    if (!isBudgeted()) {
+        return std::chrono::microseconds{0};
+    }
+
+    switch (getMode()) {
+        case PACE_RATE: {
+            const auto interval = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::duration<double>(1.0 / getStepsPerSecond()));
+            return std::clamp(interval, std::chrono::microseconds{1}, FRAME_BUDGET);
+        }
+        case PACE_FRAME_LOCKED:
+            return std::max(FRAME_BUDGET / getStepsPerFrame(), std::chrono::microseconds{1});
+        case PACE_UNTHROTTLED:
+        default:
+            return FRAME_BUDGET;
+    }
+}
+
+void SolverPacer::setStepsPerFrame(int steps) {
+    std::lock_guard lk(mtx);
+    stepsPerFrame.store(std::max(steps, 1), std::memory_order_relaxed);
+}
+
+void SolverPacer::setPaused(bool paused) {
+    {
+        std::lock_guard lk(mtx);
+        this->paused.store(paused, std::memory_order_relaxed);
+        frameCredits = 0;
+        nextStep = {};
+        version++;
+    }
+    cv.notify_all();
+}
+
+void SolverPacer::requestStep() {
+    {
+        std::lock_guard lk(mtx);
+        stepRequested = true;
+    }
+    cv.notify_all();
+}
+
+void SolverPacer::frameRendered() {
+    if (mode.load(std::memory_order_relaxed) != PACE_FRAME_LOCKED || paused.load(std::memory_order_relaxed)) {
+        return;
+    }
+    {
+        std::lock_guard lk(mtx);
+        frameCredits = stepsPerFrame.load(std::memory_order_relaxed);
+    }
+    cv.notify_all();
+}
+
+void SolverPacer::wake() {
+    {
+        std::lock_guard lk(mtx);
+        woken = true;
+    }
+    cv.notify_all();
+}
+
+bool SolverPacer::waitForStep(std::stop_token st) {
+
+    // the hot path, nothing to wait for
+    if (mode.load(std::memory_order_relaxed) == PACE_UNTHROTTLED && !paused.load(std::memory_order_relaxed)) {
+        return !st.stop_requested();
+    }
+
+    std::unique_lock lk(mtx);
+
+    while (!st.stop_requested()) {
+
+        if (stepRequested) {
+            stepRequested = false;
+            return true;
+        }
+        if (woken) {
+            woken = false;
+            return false;
+        }
+
+        // any setter bumps the version, the wait then ends and the loop looks again
+        const std::uint64_t seen = version;
+        auto interrupted = [&] { return stepRequested || woken || version != seen; };
+
+        if (paused.load(std::memory_order_relaxed)) {
+            cv.wait(lk, st, interrupted);
+            continue;
+        }
+
+        switch (mode.load(std::memory_order_relaxed)) {
+            case PACE_UNTHROTTLED:
+                return true;
+
+            case PACE_FRAME_LOCKED:
+                if (frameCredits > 0) {
+                    frameCredits--;
+                    return true;
+                }
+                cv.wait(lk, st, [&] { return interrupted() || frameCredits > 0; });
+                break;
+
+            case PACE_RATE: {
+                const auto now = std::chrono::steady_clock::now();
+                if (now >= nextStep) {
+                    // a late solver keeps its rate from now instead of bursting to catch up
+                    const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(1.0 / stepsPerSecond.load(std::memory_order_relaxed)));
+                    nextStep = std::max(nextStep, now) + interval;
+                    return true;
+                }
+                cv.wait_until(lk, st, nextStep, interrupted);
+                break;
+            }
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,57 @@
+//
+// Created by dern on 10/17/2026.
+//
+
+#include <dansweeperml/solver/registry.h>
+
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include <dansweeperml/solver/algorithm/bfsoptimized.h>
+#include <dansweeperml/solver/algorithm/frontier.h>
+#include <dansweeperml/solver/algorithm/pattern.h>
+#include <dansweeperml/solver/algorithm/probability.h>
+#include <dansweeperml/solver/algorithm/sampling.h>
+#include <dansweeperml/solver/algorithm/linearscan.h>
+
+namespace SolverRegistry {
+
+    using Factory = std::function<std::unique_ptr<ISolver>(unsigned threads)>;
+
+    static unsigned poolThreads(unsigned threads) {
+        return threads > 0 ? threads : std::thread::hardware_concurrency();
+    }
+
+    static const std::vector<std::pair<std::string, Factory>>& getFactories() {
+        static const std::vector<std::pair<std::string, Factory>> factories = {
+            {"linearscan", [](unsigned) { return std::make_unique<algorithmlinearscan::LinearScan>(); }},
+            {"bfsoptimized", [](unsigned) { return std::make_unique<algorithmbfsoptimized::BFSUnoptimized>(); }},
+            {"pattern", [](unsigned) { return std::make_unique<algorithmpattern::PatternSolver>(); }},
+            {"frontier", [](unsigned) { return std::make_unique<algorithmfrontier::FrontierSolver>(); }},
+            {"probability", [](unsigned) { return std::make_unique<algorithmprobability::ProbabilitySolver>(); }},
+            {"probabilityparallel", [](unsigned threads) { return std::make_unique<algorithmprobability::ProbabilitySolver>(poolThreads(threads)); }},
+            {"sampling", [](unsigned) { return std::make_unique<algorithmsampling::SamplingSolver>(); }},
+            {"samplingparallel", [](unsigned threads) { return std::make_unique<algorithmsampling::SamplingSolver>(poolThreads(threads)); }},
+        };
+        return factories;
+    }
+
+    std::vector<std::string> getSolverKeys() {
+        std::vector<std::string> keys;
+        for (const auto& [key, factory] : getFactories()) {
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    std::unique_ptr<ISolver> makeSolver(const std::string& key, unsigned threads) {
+        for (const auto& [name, factory] : getFactories()) {
+            if (name == key) {
+                return factory(threads);
+            }
+        }
+        return nullptr;
+    }
+
+} // SolverRegistry